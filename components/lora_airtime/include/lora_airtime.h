@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Tempo no ar de um pacote LoRa (fórmula do datasheet SX1276, sec. 4.1.1.7):
+//   Tsym = 2^SF / BW
+//   Tpreamble = (n_preamble + 4,25) * Tsym
+//   n_payload = 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) * (CR + 4), 0)
+// lora_airtime_us() é C puro (roda no host); lora_time_on_air_us() lê o PHY
+// configurado no SX127x pelos lora_get_*.
+
+typedef struct {
+    int      sf;               // 6..12
+    uint32_t bw_hz;            // 7800 .. 500000
+    int      cr;               // 1..4 -> 4/5 .. 4/8
+    int      preamble;         // símbolos programados (RegPreamble)
+    bool     implicit_header;
+    bool     crc;
+    int      ldro;             // -1 = automático (Tsym > 16 ms), 0/1 = forçado
+} lora_phy_t;
+
+// Banda em Hz p/ o índice de lora_set_bandwidth() (0 = 7,8 kHz .. 9 = 500 kHz);
+// 0 se fora da faixa
+uint32_t lora_bw_hz(int bw_index);
+
+uint32_t lora_symbol_us(const lora_phy_t *phy);
+
+// Tempo no ar de len bytes de payload, em us
+uint32_t lora_airtime_us(const lora_phy_t *phy, int len);
+
+// Idem com o PHY atual do rádio (SF, BW, CR e preâmbulo via lora_get_*).
+// Header explícito e CRC ligado: a lib não tem getters p/ eles e o projeto
+// sempre usa os dois
+uint32_t lora_time_on_air_us(int len);
@@ -0,0 +1,30 @@
+#include "lora_airtime.h"
+
+#define LDRO_SYMBOL_US   16000 // acima disso o datasheet pede LowDataRateOptimize
+
+static const uint32_t s_bw_hz[] = {
+    7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000,
+};
+
+uint32_t lora_bw_hz(int bw_index) {
+    if (bw_index < 0 || bw_index >= (int)(sizeof(s_bw_hz) / sizeof(s_bw_hz[0]))) return 0;
+    return s_bw_hz[bw_index];
+}
+
+uint32_t lora_symbol_us(const lora_phy_t *phy) {
+    if (phy->bw_hz == 0) return 0;
+    return (uint32_t)(((uint64_t)1000000 << phy->sf) / phy->bw_hz);
+}
+
+uint32_t lora_airtime_us(const lora_phy_t *phy, int len) {
+    if (phy->bw_hz == 0 || phy->sf < 6 || phy->sf > 12) return 0;
+    int de = phy->ldro >= 0 ? phy->ldro : lora_symbol_us(phy) > LDRO_SYMBOL_US;
+    int num = 8 * len - 4 * phy->sf + 28 + (phy->crc ? 16 : 0) - (phy->implicit_header ? 20 : 0);
+    int den = 4 * (phy->sf - 2 * de);
+    int blocks = num > 0 ? (num + den - 1) / den : 0;
+    int n_payload = 8 + blocks * (phy->cr + 4);
+
+    // em quartos de símbolo (o preâmbulo tem 4,25 símbolos fixos)
+    uint64_t quarters = (uint64_t)(phy->preamble * 4 + 17) + (uint64_t)n_payload * 4;
+    return (uint32_t)(((quarters * 1000000) << phy->sf) / (4ull * phy->bw_hz));
+}
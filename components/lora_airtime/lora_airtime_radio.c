@@ -0,0 +1,16 @@
+#include "lora.h"
+
+#include "lora_airtime.h"
+
+uint32_t lora_time_on_air_us(int len) {
+    lora_phy_t phy = {
+        .sf              = lora_get_spreading_factor(),
+        .bw_hz           = lora_bw_hz(lora_get_bandwidth()),
+        .cr              = lora_get_coding_rate(),
+        .preamble        = (int)lora_get_preamble_length(),
+        .implicit_header = false,
+        .crc             = true,
+        .ldro            = -1,
+    };
+    return lora_airtime_us(&phy, len);
+}
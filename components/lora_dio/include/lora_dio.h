@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+
+// DIO0 do SX127x numa interrupção de GPIO. Com o mapeamento 00
+// (lora_set_dio_mapping(0, 0)) o DIO0 sobe no RxDone em RX e no TxDone em TX;
+// a ISR notifica a task que chamou lora_dio_arm(). O mesmo nível acorda o
+// light sleep automático (CONFIG_PM_ENABLE), então a CPU dorme enquanto
+// espera o rádio em vez de fazer polling por SPI.
+
+// Configura o pino, a ISR e o wakeup de light sleep
+esp_err_t lora_dio_init(gpio_num_t dio0);
+
+// Desliga a ISR e o wakeup por GPIO (antes do deep sleep)
+void lora_dio_deinit(void);
+
+// A task atual passa a receber a próxima subida do DIO0 (descarta
+// notificações antigas). Chamar com os IRQ flags do rádio já limpos
+void lora_dio_arm(void);
+
+// Espera o DIO0 subir; false no timeout
+bool lora_dio_wait(TickType_t timeout);
@@ -0,0 +1,73 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_sleep.h"
+
+#include "lora_dio.h"
+
+static gpio_num_t s_gpio = GPIO_NUM_NC;
+static volatile TaskHandle_t s_waiter;
+
+// Interrupção por nível (é o que acorda o light sleep no ESP32): desarma no
+// primeiro disparo p/ não repetir enquanto o rádio segura o DIO0 alto.
+// Fica na flash (gpio_intr_disable também, sem CONFIG_GPIO_CTRL_FUNC_IN_IRAM):
+// com o cache desligado (escrita em flash) o disparo espera, e o nível segura
+// o pedido até lá
+static void dio0_isr(void *arg) {
+    gpio_intr_disable(s_gpio);
+    TaskHandle_t t = s_waiter;
+    if (!t) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(t, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+esp_err_t lora_dio_init(gpio_num_t dio0) {
+    if (s_gpio == dio0) return ESP_OK;
+    gpio_config_t cfg = {
+        .pin_bit_mask = 1ULL << dio0,
+        .mode         = GPIO_MODE_INPUT,
+        .pull_up_en   = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE, // o SX127x dirige o pino
+        .intr_type    = GPIO_INTR_HIGH_LEVEL,
+    };
+    esp_err_t err = gpio_config(&cfg);
+    if (err != ESP_OK) return err;
+    gpio_intr_disable(dio0);
+
+    err = gpio_install_isr_service(0); // sem ESP_INTR_FLAG_IRAM: a ISR não está na IRAM
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err; // já instalado serve
+    err = gpio_isr_handler_add(dio0, dio0_isr, NULL);
+    if (err == ESP_OK) err = gpio_wakeup_enable(dio0, GPIO_INTR_HIGH_LEVEL);
+    if (err == ESP_OK) err = esp_sleep_enable_gpio_wakeup();
+    if (err != ESP_OK) {
+        gpio_isr_handler_remove(dio0);
+        return err;
+    }
+    s_gpio = dio0;
+    return ESP_OK;
+}
+
+void lora_dio_deinit(void) {
+    if (s_gpio == GPIO_NUM_NC) return;
+    gpio_intr_disable(s_gpio);
+    gpio_wakeup_disable(s_gpio);
+    gpio_isr_handler_remove(s_gpio);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    s_waiter = NULL;
+    s_gpio = GPIO_NUM_NC;
+}
+
+void lora_dio_arm(void) {
+    if (s_gpio == GPIO_NUM_NC) return;
+    s_waiter = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, 0);
+    gpio_intr_enable(s_gpio);
+}
+
+bool lora_dio_wait(TickType_t timeout) {
+    if (s_gpio == GPIO_NUM_NC) {
+        vTaskDelay(1); // sem ISR: volta ao polling do chamador
+        return false;
+    }
+    return ulTaskNotifyTake(pdTRUE, timeout) > 0;
+}
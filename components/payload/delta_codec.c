@@ -0,0 +1,130 @@
+#include "delta_codec.h"
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t u) {
+    return (int32_t)((u >> 1) ^ (0u - (u & 1)));
+}
+
+static int varint_len(uint32_t u) {
+    int n = 1;
+    while (u >= 0x80) {
+        u >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static uint8_t *put_varint(uint8_t *o, uint32_t u) {
+    while (u >= 0x80) {
+        *o++ = (uint8_t)(u | 0x80);
+        u >>= 7;
+    }
+    *o++ = (uint8_t)u;
+    return o;
+}
+
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint32_t *u) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35 && *p < end; shift += 7) {
+        uint8_t b = *(*p)++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *u = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t delta_zz(const int32_t *v, int i) {
+    return zigzag((int32_t)((uint32_t)v[i] - (uint32_t)v[i - 1]));
+}
+
+int delta_codec_encode(const int32_t *v, int n, uint8_t *out, int cap) {
+    if (n <= 0) return 0;
+
+    // tamanho nos dois modos
+    uint32_t first = zigzag(v[0]);
+    int var_len = 0, width = 0;
+    for (int i = 1; i < n; i++) {
+        uint32_t d = delta_zz(v, i);
+        var_len += varint_len(d);
+        while (width < 32 && (d >> width) != 0) width++;
+    }
+    int bits_len = (int)(((uint32_t)(n - 1) * (uint32_t)width + 7) / 8);
+    int mode = bits_len < var_len ? DELTA_CODEC_BITS : DELTA_CODEC_VARINT;
+    int total = 1 + varint_len(first) + (mode == DELTA_CODEC_BITS ? bits_len : var_len);
+    if (total > cap) return -1;
+
+    uint8_t *o = out;
+    *o++ = (uint8_t)((mode << 6) | (mode == DELTA_CODEC_BITS ? width : 0));
+    o = put_varint(o, first);
+    if (mode == DELTA_CODEC_VARINT) {
+        for (int i = 1; i < n; i++) o = put_varint(o, delta_zz(v, i));
+    } else {
+        uint64_t acc = 0;
+        int nbits = 0;
+        for (int i = 1; i < n; i++) {
+            acc |= (uint64_t)delta_zz(v, i) << nbits;
+            nbits += width;
+            while (nbits >= 8) {
+                *o++ = (uint8_t)acc;
+                acc >>= 8;
+                nbits -= 8;
+            }
+        }
+        if (nbits > 0) *o++ = (uint8_t)acc;
+    }
+    return (int)(o - out);
+}
+
+bool delta_codec_reader_init(delta_codec_reader_t *r, const uint8_t *in, int len, int n) {
+    r->start = in;
+    r->p = in;
+    r->end = in + len;
+    r->left = n;
+    r->first = true;
+    r->prev = 0;
+    r->bitpos = 0;
+    r->mode = DELTA_CODEC_VARINT;
+    r->width = 0;
+    if (n <= 0) return true;
+    if (len < 1) return false;
+    r->mode = in[0] >> 6;
+    r->width = in[0] & 0x3F;
+    r->p++;
+    return r->mode <= DELTA_CODEC_BITS && r->width <= 32;
+}
+
+bool delta_codec_next(delta_codec_reader_t *r, int32_t *v) {
+    if (r->left <= 0) return false;
+    uint32_t u = 0;
+    if (r->first || r->mode == DELTA_CODEC_VARINT) {
+        if (!get_varint(&r->p, r->end, &u)) return false;
+    } else if (r->width > 0) {
+        uint32_t need = r->bitpos + r->width;
+        if ((uint32_t)(r->end - r->p) * 8 < need) return false;
+        for (uint32_t b = 0; b < r->width; b++) {
+            uint32_t bit = r->bitpos + b;
+            u |= (uint32_t)((r->p[bit >> 3] >> (bit & 7)) & 1) << b;
+        }
+        r->bitpos = need;
+    }
+
+    if (r->first) {
+        r->prev = unzigzag(u);
+        r->first = false;
+    } else {
+        r->prev = (int32_t)((uint32_t)r->prev + (uint32_t)unzigzag(u));
+    }
+    r->left--;
+    *v = r->prev;
+    return true;
+}
+
+int delta_codec_reader_size(const delta_codec_reader_t *r) {
+    return (int)(r->p - r->start) + (int)((r->bitpos + 7) / 8);
+}
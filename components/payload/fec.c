@@ -0,0 +1,119 @@
+#include <string.h>
+
+#include "fec.h"
+
+#define GF_POLY   0x11D // x^8 + x^4 + x^3 + x^2 + 1
+
+static uint8_t s_exp[512];
+static uint8_t s_log[256];
+static bool s_gf_ready;
+
+static void gf_init(void) {
+    if (s_gf_ready) return;
+    unsigned x = 1;
+    for (int i = 0; i < 255; i++) {
+        s_exp[i] = (uint8_t)x;
+        s_log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) x ^= GF_POLY;
+    }
+    for (int i = 255; i < 512; i++) s_exp[i] = s_exp[i - 255];
+    s_gf_ready = true;
+}
+
+static uint8_t gf_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return s_exp[s_log[a] + s_log[b]];
+}
+
+static uint8_t gf_inv(uint8_t a) {
+    return s_exp[255 - s_log[a]];
+}
+
+// Linha i da paridade, coluna j: 1 / (x_i + y_j), x_i = k + i, y_j = j
+static uint8_t cauchy(int i, int j, int k) {
+    return gf_inv((uint8_t)((k + i) ^ j));
+}
+
+// dst ^= c * src
+static void mul_add(uint8_t *dst, const uint8_t *src, uint8_t c, int len) {
+    if (c == 0) return;
+    unsigned lc = s_log[c];
+    for (int b = 0; b < len; b++) {
+        if (src[b]) dst[b] ^= s_exp[s_log[src[b]] + lc];
+    }
+}
+
+static bool valid_km(int k, int m) {
+    return k >= 1 && k <= FEC_MAX_K && m >= 0 && k + m <= FEC_MAX_SHARDS;
+}
+
+void fec_encode(const uint8_t *const *data, uint8_t *const *parity, int k, int m, int len) {
+    if (!valid_km(k, m)) return;
+    gf_init();
+    for (int i = 0; i < m; i++) {
+        memset(parity[i], 0, len);
+        for (int j = 0; j < k; j++) mul_add(parity[i], data[j], cauchy(i, j, k), len);
+    }
+}
+
+bool fec_decode(uint8_t *const *shards, const bool *present, int k, int m, int len) {
+    if (!valid_km(k, m)) return false;
+    gf_init();
+
+    // k shards recebidos, dados primeiro (linhas identidade simplificam)
+    int rows[FEC_MAX_K];
+    int nr = 0, missing = 0;
+    for (int i = 0; i < k + m && nr < k; i++) {
+        if (present[i]) rows[nr++] = i;
+    }
+    if (nr < k) return false;
+    for (int j = 0; j < k; j++) {
+        if (!present[j]) missing++;
+    }
+    if (missing == 0) return true;
+
+    // A = linhas da matriz de codificação [I; C] dos shards recebidos; inv = A^-1
+    uint8_t a[FEC_MAX_K][FEC_MAX_K];
+    uint8_t inv[FEC_MAX_K][FEC_MAX_K];
+    memset(inv, 0, sizeof(inv));
+    for (int r = 0; r < k; r++) {
+        for (int j = 0; j < k; j++) {
+            a[r][j] = rows[r] < k ? (uint8_t)(rows[r] == j) : cauchy(rows[r] - k, j, k);
+        }
+        inv[r][r] = 1;
+    }
+
+    // Gauss-Jordan (toda submatriz quadrada de [I; Cauchy] é inversível)
+    for (int col = 0; col < k; col++) {
+        int piv = col;
+        while (piv < k && a[piv][col] == 0) piv++;
+        if (piv == k) return false;
+        if (piv != col) {
+            uint8_t t[FEC_MAX_K];
+            memcpy(t, a[piv], k); memcpy(a[piv], a[col], k); memcpy(a[col], t, k);
+            memcpy(t, inv[piv], k); memcpy(inv[piv], inv[col], k); memcpy(inv[col], t, k);
+        }
+        uint8_t f = gf_inv(a[col][col]);
+        for (int j = 0; j < k; j++) {
+            a[col][j] = gf_mul(a[col][j], f);
+            inv[col][j] = gf_mul(inv[col][j], f);
+        }
+        for (int r = 0; r < k; r++) {
+            uint8_t g = a[r][col];
+            if (r == col || g == 0) continue;
+            for (int j = 0; j < k; j++) {
+                a[r][j] ^= gf_mul(g, a[col][j]);
+                inv[r][j] ^= gf_mul(g, inv[col][j]);
+            }
+        }
+    }
+
+    // dado j = soma_r inv[j][r] * shard recebido r
+    for (int j = 0; j < k; j++) {
+        if (present[j]) continue;
+        memset(shards[j], 0, len);
+        for (int r = 0; r < k; r++) mul_add(shards[j], shards[rows[r]], inv[j][r], len);
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Codec de séries inteiras p/ lotes de leituras: primeiro valor em varint
+// zig-zag e depois os deltas, em varint zig-zag ou empacotados em bits com a
+// largura do maior delta (o encoder escolhe o menor). Formato:
+//
+//   [0]   modo (2 bits altos) | largura em bits (6 bits baixos, só no modo BITS)
+//   [..]  primeiro valor (varint zig-zag)
+//   [..]  n-1 deltas: varints, ou (n-1)*largura bits LSB primeiro
+//
+// n não vai no stream (o quadro já leva a contagem). Aritmética dos deltas é
+// módulo 2^32, então qualquer int32 faz round-trip.
+
+#define DELTA_CODEC_VARINT   0
+#define DELTA_CODEC_BITS     1
+
+// Pior caso p/ n valores (cabeçalho + 5 bytes por varint)
+#define DELTA_CODEC_MAX_LEN(n)   (1 + 5 * (n))
+
+// Codifica n valores em out; devolve o nº de bytes ou -1 se não couber em cap
+int delta_codec_encode(const int32_t *v, int n, uint8_t *out, int cap);
+
+// Leitura sequencial, sem alocação
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    const uint8_t *start;
+    uint8_t  mode;
+    uint8_t  width;
+    uint32_t bitpos;     // modo BITS: bits já lidos a partir de p
+    int32_t  prev;
+    int      left;       // valores ainda não lidos
+    bool     first;
+} delta_codec_reader_t;
+
+bool delta_codec_reader_init(delta_codec_reader_t *r, const uint8_t *in, int len, int n);
+
+// Próximo valor; false no fim ou se o stream estiver truncado/malformado
+bool delta_codec_next(delta_codec_reader_t *r, int32_t *v);
+
+// Bytes ocupados pelo stream (chamar depois de ler os n valores)
+int delta_codec_reader_size(const delta_codec_reader_t *r);
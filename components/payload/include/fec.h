@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Código de apagamento Reed-Solomon sistemático (matriz de Cauchy em GF(2^8)):
+// k shards de dados de len bytes geram m shards de paridade, e quaisquer k
+// dos k+m shards reconstroem os dados. Sem alocação; tabelas de log/exp
+// montadas no primeiro uso.
+
+#define FEC_MAX_K         16
+#define FEC_MAX_SHARDS    32 // k + m
+
+// parity[i] = soma_j C[i][j] * data[j], i < m
+void fec_encode(const uint8_t *const *data, uint8_t *const *parity, int k, int m, int len);
+
+// shards[0..k-1] = dados, shards[k..k+m-1] = paridade; present[i] diz quais
+// chegaram. Reconstrói no lugar os shards de dados ausentes (os buffers
+// precisam existir). false se chegaram menos de k shards ou k/m inválidos
+bool fec_decode(uint8_t *const *shards, const bool *present, int k, int m, int len);
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "delta_codec.h"
+
+// Quadro binário do uplink, comum a emissor_s e receptor_s. Little-endian:
+//
+//   [0]     versão (4 bits altos) | tipo (4 bits baixos)
+//   [1..4]  node_id
+//   [5..6]  seq (conta quadros, não repetições do burst)
+//   [7]     flags (PAYLOAD_F_*)
+//   [8]     nº de leituras
+//   [..]    perfil por fase, se PAYLOAD_F_PROFILE:
+//           ciclos u16, nº de fases u8, (média u16, máx u16) por fase em 0,1 ms
+//   [..]    leituras, mais antiga primeiro:
+//           idade_s u16, tds_ppm u16, mv u16 [, temp_cc i16, sal_milli u16]
+//           (os dois últimos só com PAYLOAD_F_TEMP)
+//           ou, com PAYLOAD_F_DELTA, uma coluna por campo na mesma ordem,
+//           cada uma um stream do delta_codec.h com nº de leituras valores
+//
+// O decoder não aloca nem faz parse de float: valida o quadro e lê as
+// leituras direto do buffer recebido.
+//
+// Com FEC o quadro acima é dividido em k shards (+ m de paridade, fec.h) e
+// cada shard vai num pacote próprio:
+//
+//   [0]      versão | PAYLOAD_TYPE_FEC
+//   [1..4]   node_id
+//   [5..6]   seq do quadro
+//   [7]      k
+//   [8]      m
+//   [9]      índice do shard (< k: dados, >= k: paridade)
+//   [10..11] tamanho do quadro original
+//   [..]     shard (ceil(tamanho / k) bytes; o último de dados vem com zeros)
+//
+// ACK do receptor (downlink), logo após receber o quadro:
+//
+//   [0]      versão | PAYLOAD_TYPE_ACK
+//   [1..4]   node_id do emissor
+//   [5..6]   seq do quadro confirmado
+//   [7]      SF recomendado (ADR; opcional, só em ACKs de PAYLOAD_ACK_ADR_LEN;
+//            0 = sem recomendação)
+//   [8]      potência de TX recomendada, dBm (i8)
+//   [9..12]  fase do superquadro TDMA no início do TX do ACK, ms (opcional,
+//            só em ACKs de PAYLOAD_ACK_TDMA_LEN)
+//   [13..14] duração do slot, ms
+//   [15]     nº de slots do superquadro (o slot 0 é do beacon)
+//   [16]     slot atribuído ao nó
+//
+// Beacon do receptor (broadcast no início de cada superquadro):
+//
+//   [0]      versão | PAYLOAD_TYPE_BEACON
+//   [1..4]   fase do superquadro no início do TX, ms
+//   [5..6]   duração do slot, ms
+//   [7]      nº de slots
+
+#define PAYLOAD_VERSION        1
+#define PAYLOAD_HDR_LEN        9
+#define PAYLOAD_MAX_PHASES     12
+#define PAYLOAD_MAX_COLS       5  // idade, ppm, mV, temp, sal
+#define PAYLOAD_MAX_PACKED     64 // leituras por quadro comprimido
+
+#define PAYLOAD_F_TEMP         0x01 // leituras com temperatura e salinidade
+#define PAYLOAD_F_PROFILE      0x02 // bloco de perfil antes das leituras
+#define PAYLOAD_F_DELTA        0x04 // leituras em colunas comprimidas (delta_codec)
+
+#define PAYLOAD_NO_TEMP        INT16_MIN // temp_cc de leitura sem DS18B20
+
+#define PAYLOAD_FEC_HDR_LEN    12
+#define PAYLOAD_ACK_LEN        7
+#define PAYLOAD_ACK_ADR_LEN    9  // ACK com recomendação de ADR
+#define PAYLOAD_ACK_TDMA_LEN   17 // ACK com ADR + sincronismo TDMA
+#define PAYLOAD_BEACON_LEN     8
+
+typedef enum {
+    PAYLOAD_TYPE_READINGS = 1,
+    PAYLOAD_TYPE_FEC      = 2, // um shard de um quadro de leituras
+    PAYLOAD_TYPE_ACK      = 3, // confirmação receptor -> emissor
+    PAYLOAD_TYPE_BEACON   = 4, // tempo do superquadro TDMA (broadcast)
+} payload_type_t;
+
+// Relógio do superquadro TDMA do receptor (beacon e ACK)
+typedef struct {
+    uint32_t phase_ms; // posição no superquadro quando o pacote começou a sair
+    uint16_t slot_ms;
+    uint8_t  nslots;
+} payload_tdma_t;
+
+typedef struct {
+    uint32_t node_id;
+    uint16_t seq;
+    bool     has_adr;  // sf/tx_dbm valem
+    uint8_t  sf;
+    int8_t   tx_dbm;
+    bool     has_tdma; // tdma/slot valem
+    payload_tdma_t tdma;
+    uint8_t  slot;
+} payload_ack_t;
+
+typedef struct {
+    uint32_t node_id;
+    uint16_t seq;
+    uint8_t  k;
+    uint8_t  m;
+    uint8_t  idx;
+    uint16_t frame_len;
+} payload_fec_hdr_t;
+
+typedef struct {
+    uint16_t age_s;      // satura em 65535
+    uint16_t tds_ppm;
+    uint16_t mv;
+    int16_t  temp_cc;    // PAYLOAD_NO_TEMP se ausente
+    uint16_t sal_milli;
+} payload_reading_t;
+
+typedef struct {
+    uint16_t cycles;
+    uint8_t  n;
+    uint16_t avg[PAYLOAD_MAX_PHASES]; // 0,1 ms
+    uint16_t max[PAYLOAD_MAX_PHASES];
+} payload_profile_t;
+
+typedef struct {
+    uint8_t  version;
+    uint8_t  type;
+    uint32_t node_id;
+    uint16_t seq;
+    uint8_t  flags;
+    uint8_t  count;
+} payload_hdr_t;
+
+// Encoder incremental sobre um buffer do chamador
+typedef struct {
+    uint8_t *buf;
+    int cap;
+    int len;
+    uint8_t flags;
+    uint8_t count;
+} payload_writer_t;
+
+// Quadro decodificado; as leituras continuam no buffer original
+typedef struct {
+    payload_hdr_t hdr;
+    payload_profile_t profile;   // válido com PAYLOAD_F_PROFILE
+    const uint8_t *readings;
+    int reading_size;            // 0 com PAYLOAD_F_DELTA
+    int ncols;                   // só com PAYLOAD_F_DELTA:
+    const uint8_t *col[PAYLOAD_MAX_COLS];
+    int col_len[PAYLOAD_MAX_COLS];
+} payload_frame_t;
+
+// Leitura sequencial das leituras de um quadro (qualquer formato)
+typedef struct {
+    const payload_frame_t *f;
+    int i;
+    delta_codec_reader_t col[PAYLOAD_MAX_COLS];
+} payload_iter_t;
+
+// Bytes por leitura com estas flags
+int payload_reading_size(uint8_t flags);
+
+// Começa um quadro de leituras; false se cap não comporta o cabeçalho
+bool payload_writer_init(payload_writer_t *w, uint8_t *buf, int cap,
+                         uint32_t node_id, uint16_t seq, uint8_t flags);
+
+// Bloco de perfil: chamar antes da primeira leitura; false se não couber
+bool payload_writer_profile(payload_writer_t *w, const payload_profile_t *p);
+
+// Acrescenta uma leitura; false se não couber (o quadro segue válido)
+bool payload_writer_add(payload_writer_t *w, const payload_reading_t *r);
+
+// Acrescenta até n leituras comprimidas (PAYLOAD_F_DELTA): só no quadro sem
+// leituras; guarda o maior prefixo que couber e devolve quantas entraram
+int payload_writer_add_packed(payload_writer_t *w, const payload_reading_t *r, int n);
+
+// Fecha o quadro e devolve o tamanho
+int payload_writer_finish(payload_writer_t *w);
+
+// Valida e decodifica o cabeçalho (e o perfil); false se não for um quadro
+// desta versão ou se estiver truncado
+bool payload_parse(const uint8_t *buf, int len, payload_frame_t *f);
+
+// Tipo do pacote (0 se versão desconhecida)
+int payload_type(const uint8_t *buf, int len);
+
+// Monta um pacote de shard; devolve o tamanho ou 0 se não couber em cap
+int payload_fec_write(uint8_t *buf, int cap, const payload_fec_hdr_t *h,
+                      const uint8_t *shard, int shard_len);
+
+// Valida um pacote de shard; *shard aponta p/ dentro de buf
+bool payload_fec_parse(const uint8_t *buf, int len, payload_fec_hdr_t *h,
+                       const uint8_t **shard, int *shard_len);
+
+// Monta um ACK (com os blocos de ADR/TDMA conforme has_adr/has_tdma; o de
+// TDMA leva o de ADR junto, zerado se não houver); devolve o tamanho ou 0 se
+// não couber em cap
+int payload_ack_write(uint8_t *buf, int cap, const payload_ack_t *a);
+
+// Valida um ACK; has_adr/has_tdma dizem quais blocos vieram (bytes além
+// deles são ignorados)
+bool payload_ack_parse(const uint8_t *buf, int len, payload_ack_t *a);
+
+// Monta/valida um beacon
+int payload_beacon_write(uint8_t *buf, int cap, const payload_tdma_t *t);
+bool payload_beacon_parse(const uint8_t *buf, int len, payload_tdma_t *t);
+
+// i-ésima leitura do quadro (0 = mais antiga); nos quadros comprimidos
+// decodifica desde o início, p/ percorrer tudo use payload_iter_*
+bool payload_get_reading(const payload_frame_t *f, int i, payload_reading_t *out);
+
+void payload_iter_init(payload_iter_t *it, const payload_frame_t *f);
+bool payload_iter_next(payload_iter_t *it, payload_reading_t *out);
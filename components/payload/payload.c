@@ -0,0 +1,331 @@
+#include <string.h>
+
+#include "payload.h"
+#include "fec.h"
+
+#define READING_BASE_LEN   6
+#define READING_TEMP_LEN   4
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+int payload_reading_size(uint8_t flags) {
+    return READING_BASE_LEN + ((flags & PAYLOAD_F_TEMP) ? READING_TEMP_LEN : 0);
+}
+
+static int profile_size(int n) {
+    return 3 + 4 * n;
+}
+
+static int col_count(uint8_t flags) {
+    return (flags & PAYLOAD_F_TEMP) ? PAYLOAD_MAX_COLS : 3;
+}
+
+// Campo c da leitura, na ordem das colunas (idade, ppm, mV, temp, sal)
+static int32_t field_get(const payload_reading_t *r, int c) {
+    switch (c) {
+    case 0:  return r->age_s;
+    case 1:  return r->tds_ppm;
+    case 2:  return r->mv;
+    case 3:  return r->temp_cc;
+    default: return r->sal_milli;
+    }
+}
+
+static void field_set(payload_reading_t *r, int c, int32_t v) {
+    switch (c) {
+    case 0:  r->age_s = (uint16_t)v; break;
+    case 1:  r->tds_ppm = (uint16_t)v; break;
+    case 2:  r->mv = (uint16_t)v; break;
+    case 3:  r->temp_cc = (int16_t)v; break;
+    default: r->sal_milli = (uint16_t)v; break;
+    }
+}
+
+bool payload_writer_init(payload_writer_t *w, uint8_t *buf, int cap,
+                         uint32_t node_id, uint16_t seq, uint8_t flags) {
+    memset(w, 0, sizeof(*w));
+    if (cap < PAYLOAD_HDR_LEN) return false;
+    w->buf = buf;
+    w->cap = cap;
+    w->flags = flags & PAYLOAD_F_TEMP; // PROFILE só via payload_writer_profile()
+    buf[0] = (uint8_t)((PAYLOAD_VERSION << 4) | PAYLOAD_TYPE_READINGS);
+    put_u32(buf + 1, node_id);
+    put_u16(buf + 5, seq);
+    w->len = PAYLOAD_HDR_LEN;
+    return true;
+}
+
+bool payload_writer_profile(payload_writer_t *w, const payload_profile_t *p) {
+    int n = p->n > PAYLOAD_MAX_PHASES ? PAYLOAD_MAX_PHASES : p->n;
+    if (w->count > 0 || (w->flags & PAYLOAD_F_PROFILE)) return false;
+    if (w->len + profile_size(n) > w->cap) return false;
+    uint8_t *o = w->buf + w->len;
+    put_u16(o, p->cycles);
+    o[2] = (uint8_t)n;
+    o += 3;
+    for (int i = 0; i < n; i++, o += 4) {
+        put_u16(o, p->avg[i]);
+        put_u16(o + 2, p->max[i]);
+    }
+    w->len += profile_size(n);
+    w->flags |= PAYLOAD_F_PROFILE;
+    return true;
+}
+
+bool payload_writer_add(payload_writer_t *w, const payload_reading_t *r) {
+    int rs = payload_reading_size(w->flags);
+    if ((w->flags & PAYLOAD_F_DELTA) || w->count == UINT8_MAX || w->len + rs > w->cap) return false;
+    uint8_t *o = w->buf + w->len;
+    put_u16(o, r->age_s);
+    put_u16(o + 2, r->tds_ppm);
+    put_u16(o + 4, r->mv);
+    if (w->flags & PAYLOAD_F_TEMP) {
+        put_u16(o + 6, (uint16_t)r->temp_cc);
+        put_u16(o + 8, r->sal_milli);
+    }
+    w->len += rs;
+    w->count++;
+    return true;
+}
+
+int payload_writer_add_packed(payload_writer_t *w, const payload_reading_t *r, int n) {
+    if (w->count > 0 || (w->flags & PAYLOAD_F_DELTA)) return 0;
+    if (n > PAYLOAD_MAX_PACKED) n = PAYLOAD_MAX_PACKED;
+    int cols = col_count(w->flags);
+    int32_t v[PAYLOAD_MAX_PACKED];
+
+    // tenta o lote inteiro e vai tirando leituras do fim até caber
+    for (; n > 0; n--) {
+        int len = w->len;
+        int c = 0;
+        for (; c < cols; c++) {
+            for (int i = 0; i < n; i++) v[i] = field_get(&r[i], c);
+            int cl = delta_codec_encode(v, n, w->buf + len, w->cap - len);
+            if (cl < 0) break;
+            len += cl;
+        }
+        if (c == cols) {
+            w->len = len;
+            w->count = (uint8_t)n;
+            w->flags |= PAYLOAD_F_DELTA;
+            return n;
+        }
+    }
+    return 0;
+}
+
+int payload_writer_finish(payload_writer_t *w) {
+    w->buf[7] = w->flags;
+    w->buf[8] = w->count;
+    return w->len;
+}
+
+int payload_type(const uint8_t *buf, int len) {
+    if (len < 1 || (buf[0] >> 4) != PAYLOAD_VERSION) return 0;
+    return buf[0] & 0x0F;
+}
+
+int payload_fec_write(uint8_t *buf, int cap, const payload_fec_hdr_t *h,
+                      const uint8_t *shard, int shard_len) {
+    if (cap < PAYLOAD_FEC_HDR_LEN + shard_len) return 0;
+    buf[0] = (uint8_t)((PAYLOAD_VERSION << 4) | PAYLOAD_TYPE_FEC);
+    put_u32(buf + 1, h->node_id);
+    put_u16(buf + 5, h->seq);
+    buf[7] = h->k;
+    buf[8] = h->m;
+    buf[9] = h->idx;
+    put_u16(buf + 10, h->frame_len);
+    memcpy(buf + PAYLOAD_FEC_HDR_LEN, shard, shard_len);
+    return PAYLOAD_FEC_HDR_LEN + shard_len;
+}
+
+bool payload_fec_parse(const uint8_t *buf, int len, payload_fec_hdr_t *h,
+                       const uint8_t **shard, int *shard_len) {
+    if (len <= PAYLOAD_FEC_HDR_LEN || payload_type(buf, len) != PAYLOAD_TYPE_FEC) return false;
+    h->node_id   = get_u32(buf + 1);
+    h->seq       = get_u16(buf + 5);
+    h->k         = buf[7];
+    h->m         = buf[8];
+    h->idx       = buf[9];
+    h->frame_len = get_u16(buf + 10);
+    *shard = buf + PAYLOAD_FEC_HDR_LEN;
+    *shard_len = len - PAYLOAD_FEC_HDR_LEN;
+    return h->k >= 1 && h->k <= FEC_MAX_K && h->k + h->m <= FEC_MAX_SHARDS
+        && h->idx < h->k + h->m && h->frame_len > 0
+        && *shard_len == (h->frame_len + h->k - 1) / h->k;
+}
+
+static void put_tdma(uint8_t *p, const payload_tdma_t *t) {
+    put_u32(p, t->phase_ms);
+    put_u16(p + 4, t->slot_ms);
+    p[6] = t->nslots;
+}
+
+static bool get_tdma(const uint8_t *p, payload_tdma_t *t) {
+    t->phase_ms = get_u32(p);
+    t->slot_ms  = get_u16(p + 4);
+    t->nslots   = p[6];
+    return t->slot_ms > 0 && t->nslots > 1 && t->phase_ms < (uint32_t)t->slot_ms * t->nslots;
+}
+
+int payload_ack_write(uint8_t *buf, int cap, const payload_ack_t *a) {
+    int len = a->has_tdma ? PAYLOAD_ACK_TDMA_LEN : a->has_adr ? PAYLOAD_ACK_ADR_LEN : PAYLOAD_ACK_LEN;
+    if (cap < len) return 0;
+    buf[0] = (uint8_t)((PAYLOAD_VERSION << 4) | PAYLOAD_TYPE_ACK);
+    put_u32(buf + 1, a->node_id);
+    put_u16(buf + 5, a->seq);
+    if (len >= PAYLOAD_ACK_ADR_LEN) {
+        buf[7] = a->has_adr ? a->sf : 0;
+        buf[8] = a->has_adr ? (uint8_t)a->tx_dbm : 0;
+    }
+    if (a->has_tdma) {
+        put_tdma(buf + 9, &a->tdma);
+        buf[16] = a->slot;
+    }
+    return len;
+}
+
+bool payload_ack_parse(const uint8_t *buf, int len, payload_ack_t *a) {
+    if (len < PAYLOAD_ACK_LEN || payload_type(buf, len) != PAYLOAD_TYPE_ACK) return false;
+    a->node_id = get_u32(buf + 1);
+    a->seq     = get_u16(buf + 5);
+    a->has_adr = len >= PAYLOAD_ACK_ADR_LEN && buf[7] != 0;
+    a->sf      = a->has_adr ? buf[7] : 0;
+    a->tx_dbm  = a->has_adr ? (int8_t)buf[8] : 0;
+    a->has_tdma = len >= PAYLOAD_ACK_TDMA_LEN && get_tdma(buf + 9, &a->tdma) && buf[16] < a->tdma.nslots;
+    a->slot    = a->has_tdma ? buf[16] : 0;
+    return true;
+}
+
+int payload_beacon_write(uint8_t *buf, int cap, const payload_tdma_t *t) {
+    if (cap < PAYLOAD_BEACON_LEN) return 0;
+    buf[0] = (uint8_t)((PAYLOAD_VERSION << 4) | PAYLOAD_TYPE_BEACON);
+    put_tdma(buf + 1, t);
+    return PAYLOAD_BEACON_LEN;
+}
+
+bool payload_beacon_parse(const uint8_t *buf, int len, payload_tdma_t *t) {
+    return len >= PAYLOAD_BEACON_LEN && payload_type(buf, len) == PAYLOAD_TYPE_BEACON
+        && get_tdma(buf + 1, t);
+}
+
+bool payload_parse(const uint8_t *buf, int len, payload_frame_t *f) {
+    if (len < PAYLOAD_HDR_LEN) return false;
+    f->hdr.version = buf[0] >> 4;
+    f->hdr.type    = buf[0] & 0x0F;
+    if (f->hdr.version != PAYLOAD_VERSION || f->hdr.type != PAYLOAD_TYPE_READINGS) return false;
+    f->hdr.node_id = get_u32(buf + 1);
+    f->hdr.seq   = get_u16(buf + 5);
+    f->hdr.flags = buf[7];
+    f->hdr.count = buf[8];
+
+    int pos = PAYLOAD_HDR_LEN;
+    f->profile.cycles = 0;
+    f->profile.n = 0;
+    if (f->hdr.flags & PAYLOAD_F_PROFILE) {
+        if (len < pos + 3) return false;
+        int n = buf[pos + 2];
+        if (n > PAYLOAD_MAX_PHASES || len < pos + profile_size(n)) return false;
+        f->profile.cycles = get_u16(buf + pos);
+        f->profile.n = (uint8_t)n;
+        const uint8_t *p = buf + pos + 3;
+        for (int i = 0; i < n; i++, p += 4) {
+            f->profile.avg[i] = get_u16(p);
+            f->profile.max[i] = get_u16(p + 2);
+        }
+        pos += profile_size(n);
+    }
+
+    f->readings = buf + pos;
+    f->ncols = 0;
+    if (!(f->hdr.flags & PAYLOAD_F_DELTA)) {
+        f->reading_size = payload_reading_size(f->hdr.flags);
+        return len >= pos + f->hdr.count * f->reading_size;
+    }
+
+    // colunas comprimidas: percorre cada uma p/ achar onde a próxima começa
+    f->reading_size = 0;
+    f->ncols = col_count(f->hdr.flags);
+    for (int c = 0; c < f->ncols; c++) {
+        delta_codec_reader_t r;
+        if (!delta_codec_reader_init(&r, buf + pos, len - pos, f->hdr.count)) return false;
+        int32_t v;
+        for (int i = 0; i < f->hdr.count; i++) {
+            if (!delta_codec_next(&r, &v)) return false;
+        }
+        f->col[c] = buf + pos;
+        f->col_len[c] = delta_codec_reader_size(&r);
+        pos += f->col_len[c];
+    }
+    return true;
+}
+
+static void raw_reading(const payload_frame_t *f, int i, payload_reading_t *out) {
+    const uint8_t *p = f->readings + i * f->reading_size;
+    out->age_s   = get_u16(p);
+    out->tds_ppm = get_u16(p + 2);
+    out->mv      = get_u16(p + 4);
+    if (f->hdr.flags & PAYLOAD_F_TEMP) {
+        out->temp_cc   = (int16_t)get_u16(p + 6);
+        out->sal_milli = get_u16(p + 8);
+    } else {
+        out->temp_cc   = PAYLOAD_NO_TEMP;
+        out->sal_milli = 0;
+    }
+}
+
+void payload_iter_init(payload_iter_t *it, const payload_frame_t *f) {
+    it->f = f;
+    it->i = 0;
+    for (int c = 0; c < f->ncols; c++) {
+        delta_codec_reader_init(&it->col[c], f->col[c], f->col_len[c], f->hdr.count);
+    }
+}
+
+bool payload_iter_next(payload_iter_t *it, payload_reading_t *out) {
+    const payload_frame_t *f = it->f;
+    if (it->i >= f->hdr.count) return false;
+    if (f->ncols == 0) {
+        raw_reading(f, it->i++, out);
+        return true;
+    }
+    out->temp_cc = PAYLOAD_NO_TEMP;
+    out->sal_milli = 0;
+    for (int c = 0; c < f->ncols; c++) {
+        int32_t v;
+        if (!delta_codec_next(&it->col[c], &v)) return false;
+        field_set(out, c, v);
+    }
+    it->i++;
+    return true;
+}
+
+bool payload_get_reading(const payload_frame_t *f, int i, payload_reading_t *out) {
+    if (i < 0 || i >= f->hdr.count) return false;
+    if (f->ncols == 0) {
+        raw_reading(f, i, out);
+        return true;
+    }
+    payload_iter_t it;
+    payload_iter_init(&it, f);
+    for (int k = 0; k <= i; k++) {
+        if (!payload_iter_next(&it, out)) return false;
+    }
+    return true;
+}
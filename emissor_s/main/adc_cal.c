@@ -0,0 +1,123 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+
+#include "adc_cal.h"
+#include "tds_kernel.h"
+
+#define TAG "ADC_CAL"
+
+#define ADC_CAL_MAGIC   0x43414C31u // "CAL1"
+
+typedef struct {
+    uint32_t magic;
+    uint8_t  unit;
+    uint8_t  atten;
+    uint8_t  calibrated;
+    uint8_t  _pad;
+    uint16_t mv[ADC_CAL_POINTS];
+    uint32_t check;
+} adc_cal_cache_t;
+
+// Sobrevive ao deep sleep; zerada no power-on
+static RTC_DATA_ATTR adc_cal_cache_t s_cal;
+
+static uint32_t cache_check(const adc_cal_cache_t *c) {
+    // FNV-1a sobre tudo menos o próprio campo check
+    const uint8_t *p = (const uint8_t *)c;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(adc_cal_cache_t, check); i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static bool cache_valid(int unit, int atten) {
+    return s_cal.magic == ADC_CAL_MAGIC && s_cal.unit == unit && s_cal.atten == atten
+        && s_cal.check == cache_check(&s_cal);
+}
+
+static esp_err_t cali_create(int unit, int atten, adc_cali_handle_t *out) {
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t cfg = {
+        .unit_id  = unit,
+        .atten    = atten,
+        .bitwidth = ADC_BITWIDTH_12,
+    };
+    return adc_cali_create_scheme_curve_fitting(&cfg, out);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_line_fitting_config_t cfg = {
+        .unit_id  = unit,
+        .atten    = atten,
+        .bitwidth = ADC_BITWIDTH_12,
+    };
+    return adc_cali_create_scheme_line_fitting(&cfg, out);
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+static void cali_delete(adc_cali_handle_t h) {
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_delete_scheme_curve_fitting(h);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_delete_scheme_line_fitting(h);
+#endif
+}
+
+esp_err_t adc_cal_init(int unit, int atten, bool force) {
+    if (!force && cache_valid(unit, atten)) {
+        ESP_LOGI(TAG, "Calibração em cache (RTC), eFuse=%d", s_cal.calibrated);
+        return ESP_OK;
+    }
+
+    memset(&s_cal, 0, sizeof(s_cal));
+    s_cal.unit  = (uint8_t)unit;
+    s_cal.atten = (uint8_t)atten;
+
+    adc_cali_handle_t h = NULL;
+    esp_err_t err = cali_create(unit, atten, &h);
+    for (int i = 0; i < ADC_CAL_POINTS; i++) {
+        int raw = i << ADC_CAL_STEP_SHIFT;
+        if (raw > TDS_ADC_MAX) raw = TDS_ADC_MAX;
+        int mv = 0;
+        if (err == ESP_OK && adc_cali_raw_to_voltage(h, raw, &mv) == ESP_OK) {
+            s_cal.mv[i] = (uint16_t)mv;
+        } else {
+            s_cal.mv[i] = (uint16_t)(tds_raw_sum_to_uv((uint32_t)raw, 1) / 1000);
+        }
+    }
+    if (err == ESP_OK) {
+        s_cal.calibrated = 1;
+        cali_delete(h);
+        ESP_LOGI(TAG, "Calibração eFuse amostrada: %d pontos, %u..%u mV",
+                 ADC_CAL_POINTS, s_cal.mv[0], s_cal.mv[ADC_CAL_POINTS - 1]);
+    } else {
+        ESP_LOGW(TAG, "Sem calibração eFuse (%s); usando escala linear", esp_err_to_name(err));
+    }
+
+    s_cal.magic = ADC_CAL_MAGIC;
+    s_cal.check = cache_check(&s_cal);
+    return ESP_OK;
+}
+
+bool adc_cal_is_calibrated(void) {
+    return s_cal.magic == ADC_CAL_MAGIC && s_cal.calibrated;
+}
+
+uint32_t adc_cal_raw_q4_to_uv(uint32_t raw_q4) {
+    if (s_cal.magic != ADC_CAL_MAGIC) return tds_raw_sum_to_uv(raw_q4, 16);
+
+    const int shift = ADC_CAL_STEP_SHIFT + 4; // passo da tabela em Q4
+    uint32_t idx  = raw_q4 >> shift;
+    uint32_t frac = raw_q4 & ((1u << shift) - 1);
+    if (idx >= ADC_CAL_POINTS - 1) return (uint32_t)s_cal.mv[ADC_CAL_POINTS - 1] * 1000;
+
+    int32_t lo = s_cal.mv[idx], hi = s_cal.mv[idx + 1];
+    int32_t uv = lo * 1000 + (int32_t)(((int64_t)(hi - lo) * 1000 * frac) >> shift);
+    return uv > 0 ? (uint32_t)uv : 0;
+}
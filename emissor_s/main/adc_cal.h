@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Calibração do ADC via eFuse (adc_cali line/curve fitting) amostrada em uma
+// tabela raw->mV guardada na RTC slow memory: o esquema do driver é criado só
+// no boot frio; wakes por timer reaproveitam a tabela e vão direto amostrar.
+
+#define ADC_CAL_STEP_SHIFT   6                              // 1 ponto a cada 64 contagens
+#define ADC_CAL_POINTS       ((4096 >> ADC_CAL_STEP_SHIFT) + 1)
+
+// Garante a tabela em RTC. Recalcula se force=true ou se o cache for inválido.
+// Se o chip não tiver eFuse de calibração, cai na escala linear VREF/4095.
+esp_err_t adc_cal_init(int unit, int atten, bool force);
+
+// true se a tabela vem de calibração eFuse (false = escala linear de fallback)
+bool adc_cal_is_calibrated(void);
+
+// Média bruta em Q4 (contagens * 16) -> tensão em uV, interpolando a tabela
+uint32_t adc_cal_raw_q4_to_uv(uint32_t raw_q4);
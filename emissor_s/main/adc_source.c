@@ -0,0 +1,166 @@
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
+
+#include "adc_source.h"
+
+#define TAG "ADC_SRC"
+
+#define ADC_DMA_FRAME_MAX     256  // maior frame DMA (bytes); o frame é do tamanho de uma leitura
+#define ADC_DMA_POOL_BYTES    1024 // buffer interno do driver
+#define ADC_READ_TIMEOUT_MS   50
+
+// ---------- Oneshot ----------
+
+typedef struct {
+    adc_oneshot_unit_handle_t unit;
+    adc_channel_t channel;
+    uint32_t period_us;
+} oneshot_ctx_t;
+
+static oneshot_ctx_t s_oneshot;
+
+static esp_err_t oneshot_start(adc_source_t *src) {
+    return ESP_OK; // nada a armar: cada leitura é síncrona
+}
+
+static int oneshot_read(adc_source_t *src, uint16_t *out, int n) {
+    oneshot_ctx_t *c = src->ctx;
+    // pdMS_TO_TICKS(2) vira 0 tick com CONFIG_FREERTOS_HZ=100; espaça por deadline em us
+    int64_t next = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        while (esp_timer_get_time() < next) { }
+        int raw = 0;
+        if (adc_oneshot_read(c->unit, c->channel, &raw) != ESP_OK) return i;
+        out[i] = (uint16_t)raw;
+        next += c->period_us;
+    }
+    return n;
+}
+
+static void oneshot_stop(adc_source_t *src) {
+    oneshot_ctx_t *c = src->ctx;
+    if (c->unit) {
+        adc_oneshot_del_unit(c->unit);
+        c->unit = NULL;
+    }
+}
+
+esp_err_t adc_source_oneshot_init(adc_source_t *src, int unit, int channel, uint32_t sample_rate_hz) {
+    oneshot_ctx_t *c = &s_oneshot;
+    memset(c, 0, sizeof(*c));
+    adc_oneshot_unit_init_cfg_t unit_cfg = {.unit_id = (adc_unit_t)unit};
+    esp_err_t err = adc_oneshot_new_unit(&unit_cfg, &c->unit);
+    if (err != ESP_OK) return err;
+    adc_oneshot_chan_cfg_t ch_cfg = { .bitwidth = ADC_BITWIDTH_12, .atten = ADC_ATTEN_DB_11 };
+    err = adc_oneshot_config_channel(c->unit, (adc_channel_t)channel, &ch_cfg);
+    if (err != ESP_OK) {
+        adc_oneshot_del_unit(c->unit);
+        c->unit = NULL;
+        return err;
+    }
+    c->channel = (adc_channel_t)channel;
+    c->period_us = sample_rate_hz ? 1000000U / sample_rate_hz : 0;
+
+    src->start = oneshot_start;
+    src->read  = oneshot_read;
+    src->stop  = oneshot_stop;
+    src->ctx   = c;
+    return ESP_OK;
+}
+
+// ---------- Contínuo (DMA) ----------
+
+typedef struct {
+    adc_continuous_handle_t handle;
+    adc_channel_t channel;
+    uint32_t frame_bytes;
+    bool running;
+} cont_ctx_t;
+
+static cont_ctx_t s_cont;
+
+static esp_err_t cont_start(adc_source_t *src) {
+    cont_ctx_t *c = src->ctx;
+    esp_err_t err = adc_continuous_start(c->handle);
+    if (err == ESP_OK) c->running = true;
+    return err;
+}
+
+static int cont_read(adc_source_t *src, uint16_t *out, int n) {
+    cont_ctx_t *c = src->ctx;
+    uint8_t frame[ADC_DMA_FRAME_MAX];
+    int got = 0;
+    while (got < n) {
+        uint32_t len = 0;
+        esp_err_t err = adc_continuous_read(c->handle, frame, c->frame_bytes, &len, ADC_READ_TIMEOUT_MS);
+        if (err != ESP_OK) break; // timeout: devolve o que conseguiu
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len && got < n; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t *d = (adc_digi_output_data_t *)&frame[i];
+            if (d->type1.channel != c->channel) continue;
+            out[got++] = (uint16_t)d->type1.data;
+        }
+    }
+    return got;
+}
+
+static void cont_stop(adc_source_t *src) {
+    cont_ctx_t *c = src->ctx;
+    if (!c->handle) return;
+    if (c->running) adc_continuous_stop(c->handle);
+    adc_continuous_deinit(c->handle);
+    c->handle = NULL;
+    c->running = false;
+}
+
+esp_err_t adc_source_continuous_init(adc_source_t *src, int unit, int channel, uint32_t sample_rate_hz,
+                                     int frame_samples) {
+    cont_ctx_t *c = &s_cont;
+    memset(c, 0, sizeof(*c));
+
+    // o DMA só entrega frames inteiros: um frame do tamanho da leitura evita
+    // esperar amostras que ninguém vai usar (256 bytes = 6,4 ms a 20 kHz)
+    uint32_t bytes = (uint32_t)frame_samples * SOC_ADC_DIGI_RESULT_BYTES;
+    bytes = (bytes + SOC_ADC_DIGI_DATA_BYTES_PER_CONV - 1) / SOC_ADC_DIGI_DATA_BYTES_PER_CONV
+          * SOC_ADC_DIGI_DATA_BYTES_PER_CONV;
+    if (bytes == 0 || bytes > ADC_DMA_FRAME_MAX) return ESP_ERR_INVALID_ARG;
+    c->frame_bytes = bytes;
+
+    adc_continuous_handle_cfg_t h_cfg = {
+        .max_store_buf_size = ADC_DMA_POOL_BYTES,
+        .conv_frame_size    = bytes,
+    };
+    esp_err_t err = adc_continuous_new_handle(&h_cfg, &c->handle);
+    if (err != ESP_OK) return err;
+
+    adc_digi_pattern_config_t pattern = {
+        .atten     = ADC_ATTEN_DB_11,
+        .channel   = channel,
+        .unit      = unit,
+        .bit_width = ADC_BITWIDTH_12,
+    };
+    adc_continuous_config_t cfg = {
+        .pattern_num    = 1,
+        .adc_pattern    = &pattern,
+        .sample_freq_hz = sample_rate_hz,
+        .conv_mode      = ADC_CONV_SINGLE_UNIT_1, // no ESP32 o DMA só atende o ADC1
+        .format         = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    };
+    err = adc_continuous_config(c->handle, &cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "config contínuo falhou (%s), taxa=%lu Hz", esp_err_to_name(err), (unsigned long)sample_rate_hz);
+        adc_continuous_deinit(c->handle);
+        c->handle = NULL;
+        return err;
+    }
+    c->channel = (adc_channel_t)channel;
+
+    src->start = cont_start;
+    src->read  = cont_read;
+    src->stop  = cont_stop;
+    src->ctx   = c;
+    return ESP_OK;
+}
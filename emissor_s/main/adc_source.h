@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Fonte de amostras brutas do ADC (0..4095). Esconde se a captura é oneshot,
+// contínua via DMA ou sintética (tests/host/adc_source_synth.h, p/ rodar o
+// pipeline no host sem hardware).
+typedef struct adc_source adc_source_t;
+
+struct adc_source {
+    // Arma a captura; no modo contínuo o DMA já começa a encher o buffer
+    // enquanto a CPU faz outras coisas (ex.: lora_init)
+    esp_err_t (*start)(adc_source_t *src);
+    // Bloqueia até obter n amostras (ou timeout); retorna quantas foram lidas
+    int (*read)(adc_source_t *src, uint16_t *out, int n);
+    // Para a captura e libera o hardware (antes do deep sleep)
+    void (*stop)(adc_source_t *src);
+    void *ctx;
+};
+
+static inline esp_err_t adc_source_start(adc_source_t *src) { return src->start(src); }
+static inline int adc_source_read(adc_source_t *src, uint16_t *out, int n) { return src->read(src, out, n); }
+static inline void adc_source_stop(adc_source_t *src) { if (src->stop) src->stop(src); }
+
+// Oneshot com espaçamento real entre amostras (espera ocupada por deadline em us)
+esp_err_t adc_source_oneshot_init(adc_source_t *src, int unit, int channel, uint32_t sample_rate_hz);
+
+// Contínuo (DMA): taxa fixa definida pelo hardware; no ESP32 o mínimo é 20 kHz.
+// frame_samples = amostras por frame DMA (as de uma leitura)
+esp_err_t adc_source_continuous_init(adc_source_t *src, int unit, int channel, uint32_t sample_rate_hz,
+                                     int frame_samples);
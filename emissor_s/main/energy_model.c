@@ -0,0 +1,33 @@
+#include "energy_model.h"
+
+#define US_PER_HOUR   3600e6f // mA*us -> uAh: dividir por 3,6e6
+#define S_PER_DAY     86400.0f
+
+energy_estimate_t energy_estimate(const energy_profile_t *p, const energy_cycle_t *c) {
+    energy_estimate_t e = { 0 };
+    float per_tx = c->cycles_per_tx ? (float)c->cycles_per_tx : 1.0f;
+
+    // Rádio: TX durante o tempo no ar, standby no resto; a CPU fica acordada
+    // junto, menos o tempo em light sleep esperando TxDone/ACK/intervalo
+    float air_us = (float)c->toa_us * (float)c->tx_packets;
+    if (air_us > (float)c->radio_on_us) air_us = (float)c->radio_on_us;
+    float cpu_sleep_us = (float)c->cpu_sleep_us;
+    if (cpu_sleep_us > (float)c->radio_on_us) cpu_sleep_us = (float)c->radio_on_us;
+    float radio_uah = (air_us * p->tx_ma
+                    + ((float)c->radio_on_us - air_us) * p->radio_idle_ma
+                    + ((float)c->radio_on_us - cpu_sleep_us) * p->active_ma
+                    + cpu_sleep_us * p->light_sleep_ma) * 1000.0f / US_PER_HOUR;
+    radio_uah /= per_tx;
+
+    float sleep_uah = p->sleep_ua * (float)c->sleep_s / 3600.0f;
+    float awake_uah = ((float)c->awake_us * p->active_ma
+                     + (float)c->adc_us * p->adc_ma) * 1000.0f / US_PER_HOUR;
+
+    e.cycle_uah = sleep_uah + awake_uah + radio_uah;
+    e.cycle_s = (float)c->sleep_s
+              + ((float)c->awake_us + (float)c->radio_on_us / per_tx) / 1e6f;
+    if (e.cycle_uah > 0.0f) e.tx_share = radio_uah / e.cycle_uah;
+    if (e.cycle_s > 0.0f) e.mah_per_day = e.cycle_uah / 1000.0f * (S_PER_DAY / e.cycle_s);
+    if (e.mah_per_day > 0.0f) e.life_days = p->battery_mah / e.mah_per_day;
+    return e;
+}
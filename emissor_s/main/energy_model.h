@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+// Modelo de energia do ciclo do emissor (deep sleep + wake + rádio).
+// C puro, sem IDF: o mesmo código estima no dispositivo (com os tempos do
+// phase_prof e o tempo no ar de lora_time_on_air_us) e roda no host p/ comparar
+// SLEEP_SECONDS, janela de burst, SF e tamanho de lote antes do deploy.
+
+typedef struct {
+    float sleep_ua;        // placa inteira em deep sleep
+    float active_ma;       // CPU acordada, rádio dormindo
+    float adc_ma;          // adicional durante o burst do ADC
+    float tx_ma;           // SX127x transmitindo (depende da potência)
+    float radio_idle_ma;   // SX127x em standby entre reenvios do burst
+    float light_sleep_ma;  // CPU em light sleep esperando o rádio (= active_ma sem PM)
+    float battery_mah;     // capacidade útil da bateria
+} energy_profile_t;
+
+typedef struct {
+    uint32_t sleep_s;        // deep sleep entre wakes
+    uint32_t awake_us;       // wake sem rádio (boot, ADC, temp, processamento, sono)
+    uint32_t adc_us;         // parte de awake_us com o ADC convertendo
+    uint32_t radio_on_us;    // rádio ligado numa transmissão (init + burst)
+    uint32_t cpu_sleep_us;   // parte de radio_on_us com a CPU em light sleep
+    uint32_t toa_us;         // tempo no ar de um pacote
+    uint32_t tx_packets;     // pacotes por transmissão (com as repetições do burst)
+    uint32_t cycles_per_tx;  // wakes por transmissão (lote; 1 = rádio todo wake)
+} energy_cycle_t;
+
+typedef struct {
+    float cycle_s;         // duração média de um ciclo
+    float cycle_uah;       // carga média por ciclo (TX rateado pelo lote)
+    float tx_share;        // fração da carga gasta com rádio
+    float mah_per_day;
+    float life_days;       // battery_mah / mah_per_day
+} energy_estimate_t;
+
+energy_estimate_t energy_estimate(const energy_profile_t *p, const energy_cycle_t *c);
@@ -0,0 +1,33 @@
+#include "mac_sched.h"
+
+// finalizador do murmur3: avalanche completa, IDs vizinhos caem longe
+static uint32_t mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+void mac_sched_init(mac_sched_t *m, uint32_t node_id, uint32_t seed) {
+    m->rng = mix32(seed ^ mix32(node_id));
+    if (m->rng == 0) m->rng = 0x9E3779B9u;
+}
+
+uint32_t mac_slot_offset_ms(uint32_t node_id, uint32_t span_ms) {
+    return span_ms ? mix32(node_id) % span_ms : 0;
+}
+
+uint32_t mac_rand(mac_sched_t *m, uint32_t bound) {
+    uint32_t x = m->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    m->rng = x;
+    return bound ? (uint32_t)(((uint64_t)x * bound) >> 32) : 0;
+}
+
+int32_t mac_jitter_ms(mac_sched_t *m, uint32_t max_ms) {
+    return (int32_t)mac_rand(m, 2 * max_ms + 1) - (int32_t)max_ms;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Agendamento do acesso ao canal com vários emissores por receptor (ALOHA
+// com desalinhamento). Sem relógio comum, nós ligados juntos acordariam e
+// transmitiriam em fase para sempre (mesmo timer): o offset de slot, derivado
+// do node_id, separa o primeiro envio após o boot frio, e o jitter limitado
+// no timer do deep sleep e nos intervalos do burst impede que dois nós
+// fiquem alinhados por muitos ciclos. Não depende de hardware (o simulador
+// de colisões no host usa o mesmo código).
+
+typedef struct {
+    uint32_t rng;   // estado do xorshift32 (nunca 0)
+} mac_sched_t;
+
+// Semeia o gerador (boot frio); seed = entropia do hardware, misturada ao node_id
+void mac_sched_init(mac_sched_t *m, uint32_t node_id, uint32_t seed);
+
+// Offset fixo do nó em [0, span_ms): hash do node_id, espalha IDs sequenciais
+uint32_t mac_slot_offset_ms(uint32_t node_id, uint32_t span_ms);
+
+// Uniforme em [0, bound)
+uint32_t mac_rand(mac_sched_t *m, uint32_t bound);
+
+// Uniforme em [-max_ms, +max_ms]
+int32_t mac_jitter_ms(mac_sched_t *m, uint32_t max_ms);
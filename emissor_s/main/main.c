@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <sys/time.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -9,111 +10,519 @@
 #include "esp_system.h"
 
 #include "driver/adc.h"
+#include "driver/gpio.h"
 #include "esp_adc/adc_oneshot.h"
 
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_pm.h"
+#include "esp_random.h"
+#include "esp_mac.h"
+
 #include "lora.h"
+#include "adc_source.h"
+#include "tds_kernel.h"
+#include "sample_reducer.h"
+#include "adc_cal.h"
+#include "temp_sensor.h"
+#include "salinity.h"
+#include "reading_log.h"
+#include "report_sched.h"
+#include "ulp_sampler.h"
+#include "wake_stub.h"
+#include "phase_prof.h"
+#include "energy_model.h"
+#include "mac_sched.h"
+#include "tdma_sync.h"
+#include "payload.h"
+#include "fec.h"
+#include "lora_airtime.h"
+#include "lora_dio.h"
 
 #define TAG "TX_TDS_SLEEP"
 
 #define VREF            3.3f // tensão de referência usada p/ converter o ADC
-#define SAMPLES         32 // nº de amostras p/ média
-#define TEMPERATURE_C   25.0f // temperatura usada p/ compensação TDS
+#define SAMPLES         32 // nº de amostras por burst (<= REDUCER_MAX_SAMPLES)
+#define TEMPERATURE_C   25.0f // temperatura de fallback se o DS18B20 falhar
 #define TDS_GPIO        32 
 #define ADC_UNIT_ID     ADC_UNIT_1
 #define ADC_CHANNEL     ADC_CHANNEL_4 // GPIO32 no ADC1
-#define SLEEP_SECONDS   30 // tempo de deep sleep entre ciclos
-#define SLEEP_US        ((uint64_t)SLEEP_SECONDS * 1000000ULL)
+#define SLEEP_SECONDS   30 // tempo de deep sleep padrão (antes do agendador decidir)
 
 #define TX_BURST_WINDOW_MS   5000  // janela total do "burst" (~5 s transmitindo)
-#define TX_BURST_GAP_MS       500  // intervalo entre reenvios dentro do burst
+#define TX_BURST_GAP_MS       500  // intervalo mínimo entre reenvios dentro do burst
+#define LORA_MAX_PAYLOAD      255  // limite do FIFO do SX127x
+#define LORA_DIO0_GPIO         26  // DIO0 do SX1276 na Heltec LoRa32 v2 (TxDone/RxDone)
+
+// Light sleep automático (CONFIG_PM_ENABLE + tickless idle): enquanto a task
+// espera o rádio (TxDone no polling da lib, janela de ACK, intervalo do burst)
+// a CPU dorme; o DIO0 e o timer do próximo tick acordam
+#define PM_MAX_FREQ_MHZ       160
+#define PM_MIN_FREQ_MHZ        40  // XTAL
+
+// FEC (fec.h): cada quadro vira até FEC_K shards de dados + FEC_M de paridade,
+// mandados uma vez cada, espaçados por TX_BURST_GAP_MS; o receptor remonta com
+// quaisquer k. TX_USE_FEC 0 volta à repetição do quadro inteiro no burst
+#define TX_USE_FEC              1
+#define FEC_K                   2
+#define FEC_M                   6
+#define FEC_MIN_SHARD          24  // quadros curtos usam menos shards de dados
+#define FEC_MAX_FRAME         (LORA_MAX_PAYLOAD - PAYLOAD_FEC_HDR_LEN) // cabe com k = 1
+
+// ACK: depois de cada pacote abre uma janela de RX; o receptor confirma
+// (nó, seq) e o burst/FEC para no primeiro ACK
+#define TX_USE_ACK              1
+#define ACK_TURNAROUND_MS     150  // reação do receptor: RX_ACK_DELAY_MS (40) fixo após o RxDone + até um
+                                   // tick de arredondamento + parse; a janela é isso + o tempo no ar
+                                   // do ACK no PHY atual
+#define NODE_ID                 0  // identifica este emissor no quadro binário;
+                                   // 0 = deriva do MAC de fábrica (efuse)
+
+// ADR: o ACK traz SF/potência recomendados pelo receptor (pelo SNR medido);
+// ficam em RTC e valem a partir do próximo pacote. Após ADR_MISS_LIMIT
+// quadros seguidos sem ACK volta ao PHY padrão (o receptor também volta)
+#define TX_USE_ADR              1
+#define TX_POWER_DBM           17  // potência padrão (PA_BOOST, 2..17 dBm)
+#define ADR_MISS_LIMIT          2
+
+// Duty cycle (balde furado em RTC): o tempo no ar gasto escoa a TX_DUTY_PPM do
+// tempo real, e o balde cabe TX_DUTY_WINDOW_S disso (1 % -> 36 s por hora).
+// Em 915 MHz não há limite legal, é política de boa vizinhança; 0 desliga
+#define TX_DUTY_PPM         10000
+#define TX_DUTY_WINDOW_S     3600
+
+// Acesso ao canal com vários emissores (mac_sched.h)
+#define MAC_SLOT_SPAN_MS    10000  // boot frio: 1º envio atrasado 0..10 s pelo hash do node_id
+#define MAC_WAKE_JITTER_MS   1500  // +/- no timer do deep sleep
+#define MAC_TX_JITTER_MS     1000  // espera aleatória (rádio desligado) antes de cada lote
+#define MAC_GAP_JITTER_MS     200  // somado ao intervalo entre pacotes do burst
+
+// TDMA (tdma_sync.h): com sincronismo recente (ACK ou beacon do receptor) o
+// emissor só transmite no slot atribuído e manda só TDMA_FEC_M de paridade;
+// sem sincronismo volta ao ALOHA do mac_sched
+#define TX_USE_TDMA             1
+#define TDMA_GUARD_MS         300  // TX começa isso depois do início do slot (erro de fase)
+#define TDMA_SYNC_MAX_S      1800  // sincronismo mais velho que isso não vale
+#define TDMA_FEC_M              2  // paridade no slot: só desvanecimento, sem colisão
+#define TDMA_AWAKE_WAIT_MS   3000  // até isso espera o slot acordado (light sleep)...
+#define TDMA_WAKE_LEAD_MS    1000  // ...senão deep sleep e acorda isso antes (boot + medição)
+
+#define BATCH_SIZE             8   // liga o rádio a cada N leituras acumuladas...
+#define BATCH_MAX_AGE_S      300   // ...ou quando a mais antiga passar desse tempo (s)
+
+// Send-on-delta: só enfileira leituras que andaram ou quando vence o heartbeat
+#define SOD_DELTA_PPM         10   // variação de TDS que força reporte
+#define SOD_HEARTBEAT_S     1800   // reporta ao menos a cada 30 min
+#define SOD_SLEEP_MIN_S       15   // sono com TDS variando rápido
+#define SOD_SLEEP_MAX_S      120   // sono com TDS parado
+#define SOD_FAST_PPM_H       200   // taxa (ppm/h) em que o sono chega ao mínimo
+
+// ULP (CONFIG_ULP_COPROC_ENABLED): amostra no deep sleep e só acorda as CPUs
+// quando juntar ULP_BATCH médias ou a leitura sair de +/-ULP_WAKE_DELTA_RAW
+#define ULP_BATCH             16
+#define ULP_WAKE_DELTA_RAW    25   // contagens (~20 mV a 11 dB)
+
+#define ADC_USE_CONTINUOUS   1      // 1 = captura contínua via DMA; 0 = oneshot espaçado
+#define ADC_SAMPLE_RATE_HZ   20000  // taxa fixa de amostragem (contínuo no ESP32: mín. 20 kHz)
+#define ADC_REDUCER          REDUCER_TRIMMED_MEAN // redutor do burst (ver sample_reducer.h)
+
+#define TEMP_GPIO            13     // DS18B20 no 1-wire (pull-up externo de 4k7)
+#define TEMP_RES_BITS        9      // 0,5 °C (~1 % no TDS); conversão ~94 ms, quase toda no
+                                    // caminho crítico (10 bits: ~188 ms)
+#define TEMP_TIMEOUT_MS      1000
+
+// Perfil de corrente p/ o modelo de energia (medir na placa e ajustar)
+#define ENERGY_SLEEP_UA      20.0f  // deep sleep (Heltec v2 sem modificações gasta bem mais)
+#define ENERGY_ACTIVE_MA     45.0f  // CPU a 160 MHz, Wi-Fi/BT desligados
+#define ENERGY_ADC_MA         2.0f  // adicional do SAR ADC
+#define ENERGY_TX_MA        120.0f  // SX1276 a +17 dBm (PA_BOOST)
+#define ENERGY_RADIO_IDLE_MA  1.6f  // SX1276 em standby
+#define ENERGY_LIGHT_SLEEP_MA 0.8f  // ESP32 em light sleep (no lugar de ENERGY_ACTIVE_MA)
+#define ENERGY_BATTERY_MAH 2000.0f
+
+static adc_source_t s_adc_src;
+static bool s_adc_ready;
+
+static temp_sensor_t s_temp;
+static bool s_temp_ok;
+
+static uint32_t s_sleep_s = SLEEP_SECONDS;
+static uint16_t s_last_raw; // média bruta da última leitura deste wake
+static RTC_DATA_ATTR report_state_t s_report;
+static RTC_DATA_ATTR uint32_t s_ulp_period_s; // período com que o ULP foi armado
+static RTC_DATA_ATTR uint32_t s_ulp_armed_s;  // now_s() do arm (base dos tempos das médias)
+static RTC_DATA_ATTR uint32_t s_node_id;      // node_id do quadro (node_id_init no boot frio)
+static RTC_DATA_ATTR uint16_t s_tx_seq;       // nº de sequência do próximo quadro
+static RTC_DATA_ATTR mac_sched_t s_mac;       // gerador do jitter de MAC
+static RTC_DATA_ATTR tdma_sync_t s_tdma;      // fase/drift do superquadro do receptor
+static RTC_DATA_ATTR bool s_tdma_tx_due;      // lote adiado p/ o slot; transmite no próximo wake
+static int64_t s_wake_at_ms;                  // > 0: acordar nesse instante (slot), sem jitter
+static int64_t s_slot_end_ms;                 // > 0: transmitindo no slot, que acaba aqui
+
+// Recomendação de ADR em uso (0 = padrão)
+typedef struct {
+    uint8_t sf;
+    int8_t tx_dbm;
+    uint8_t misses;  // quadros seguidos sem ACK com a recomendação
+} radio_adr_t;
+static RTC_DATA_ATTR radio_adr_t s_adr;
+#if TX_USE_ACK
+static payload_ack_t s_ack; // último ACK aceito
+#endif
+
+static RTC_DATA_ATTR uint32_t s_duty_used_us; // tempo no ar ainda no balde do duty cycle
+static RTC_DATA_ATTR uint32_t s_duty_t_s;     // now_s() do último escoamento
 
-static adc_oneshot_unit_handle_t s_adc;
+static uint32_t s_tx_air_us;   // soma do tempo no ar (lora_time_on_air_us) neste wake
+static uint32_t s_tx_packets;
+static uint32_t s_radio_wait_us; // rádio ligado com a task bloqueada (CPU livre p/ light sleep)
 
-// Inicializa ADC1 em modo oneshot no canal do GPIO32 com 12 bits e 11 dB de atenuação
+static const energy_profile_t s_energy_profile = {
+    .sleep_ua      = ENERGY_SLEEP_UA,
+    .active_ma     = ENERGY_ACTIVE_MA,
+    .adc_ma        = ENERGY_ADC_MA,
+    .tx_ma         = ENERGY_TX_MA,
+    .radio_idle_ma = ENERGY_RADIO_IDLE_MA,
+#if CONFIG_PM_ENABLE
+    .light_sleep_ma = ENERGY_LIGHT_SLEEP_MA,
+#else
+    .light_sleep_ma = ENERGY_ACTIVE_MA,
+#endif
+    .battery_mah   = ENERGY_BATTERY_MAH,
+};
+
+static const report_cfg_t s_report_cfg = {
+    .delta       = SOD_DELTA_PPM,
+    .heartbeat_s = SOD_HEARTBEAT_S,
+    .sleep_min_s = SOD_SLEEP_MIN_S,
+    .sleep_max_s = SOD_SLEEP_MAX_S,
+    .fast_rate_h = SOD_FAST_PPM_H,
+};
+
+// Inicializa ADC1 no canal do GPIO32 (12 bits, 11 dB) e já arma a captura;
+// no modo contínuo o DMA enche o buffer enquanto a CPU segue o wake
 static void adc_init(void) {
-    adc_oneshot_unit_init_cfg_t unit_cfg = {.unit_id = ADC_UNIT_ID};
-    ESP_ERROR_CHECK(adc_oneshot_new_unit(&unit_cfg, &s_adc));
-    adc_oneshot_chan_cfg_t ch_cfg = { .bitwidth = ADC_BITWIDTH_12, .atten = ADC_ATTEN_DB_11 };
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(s_adc, ADC_CHANNEL, &ch_cfg));
+#if ADC_USE_CONTINUOUS
+    ESP_ERROR_CHECK(adc_source_continuous_init(&s_adc_src, ADC_UNIT_ID, ADC_CHANNEL, ADC_SAMPLE_RATE_HZ, SAMPLES));
+#else
+    ESP_ERROR_CHECK(adc_source_oneshot_init(&s_adc_src, ADC_UNIT_ID, ADC_CHANNEL, ADC_SAMPLE_RATE_HZ));
+#endif
+    s_adc_ready = true;
+    ESP_ERROR_CHECK(adc_source_start(&s_adc_src));
 }
 
-// Libera o handle do ADC (boa prática antes de dormir)
+// Libera o ADC (boa prática antes de dormir)
 static void adc_deinit(void) {
-    if (s_adc) {
-        adc_oneshot_del_unit(s_adc);
-        s_adc = NULL;
+    if (s_adc_ready) {
+        adc_source_stop(&s_adc_src);
+        s_adc_ready = false;
+    }
+}
+
+// Dispara a conversão de temperatura logo no início do wake. Só o init do
+// ADC e o burst (~2 ms) correm em paralelo; o resto (~90 ms a 9 bits) é
+// espera em read_temperature_cc(), antes do rádio
+static void temp_start(void) {
+    s_temp_ok = temp_sensor_ds18b20_init(&s_temp, TEMP_GPIO, TEMP_RES_BITS) == ESP_OK
+             && temp_sensor_start(&s_temp) == ESP_OK;
+    if (!s_temp_ok) ESP_LOGW(TAG, "DS18B20 não respondeu; usando %.1f °C", TEMPERATURE_C);
+}
+
+// Temperatura em centésimos de °C; se o sensor falhar devolve TEMPERATURE_C
+// e *measured = false
+static int32_t read_temperature_cc(bool *measured) {
+    int32_t cc = 0;
+    *measured = false;
+    if (s_temp_ok) {
+        esp_err_t err = temp_sensor_read(&s_temp, &cc, TEMP_TIMEOUT_MS);
+        if (err == ESP_OK) {
+            *measured = true;
+            return cc;
+        }
+        ESP_LOGW(TAG, "Leitura DS18B20 falhou: %s", esp_err_to_name(err));
+        s_temp_ok = false;
     }
+    return (int32_t)(TEMPERATURE_C * 100.0f);
 }
 
-// Lê SAMPLES amostras, faz média, converte p/ tensão e calcula TDS (ppm)
-// Retorna TDS; se out_voltage != NULL, devolve a tensão lida (antes da compensação)
-static float read_tds_ppm(float *out_voltage) {
-    int sum = 0;
-    for (int i = 0; i < SAMPLES; i++) {
-        int raw = 0;
-        ESP_ERROR_CHECK(adc_oneshot_read(s_adc, ADC_CHANNEL, &raw));
-        sum += raw;
-        vTaskDelay(pdMS_TO_TICKS(2)); // pequeno intervalo p/ reduzir ruído/acoplamento
+// Lê SAMPLES amostras, reduz (ADC_REDUCER) e devolve a tensão da sonda em uV;
+// guarda a média bruta em s_last_raw (centro da janela do ULP)
+static uint32_t read_probe_uv(void) {
+    uint16_t samples[SAMPLES];
+    int64_t t0 = esp_timer_get_time();
+    int n = adc_source_read(&s_adc_src, samples, SAMPLES);
+    int64_t dt_us = esp_timer_get_time() - t0;
+    ESP_LOGI(TAG, "ADC: %d amostras em %lld us", n, (long long)dt_us);
+    if (n <= 0) {
+        ESP_LOGE(TAG, "ADC sem amostras");
+        return 0;
     }
-    float raw_avg = (float)sum / (float)SAMPLES;
-    float voltage = raw_avg * (VREF / 4095.0f); // 12 bits -> 0..4095
 
-    // Compensação simples de temperatura (coef. típico 2%/°C)
-    float comp_coeff   = 1.0f + 0.02f * (TEMPERATURE_C - 25.0f);
-    float comp_voltage = voltage / comp_coeff;
+    // Redução robusta (mediana/média aparada/sigma-clip) em vez da média simples
+    uint32_t raw_q4 = reducer_apply(ADC_REDUCER, samples, n);
+    s_last_raw = (uint16_t)((raw_q4 + 8) >> 4);
+    return adc_cal_raw_q4_to_uv(raw_q4); // curva eFuse em cache (RTC)
+}
+
+// Calcula TDS (ppm) a partir da tensão, compensado pela temperatura medida
+static float tds_from_uv(uint32_t uv, int32_t temp_cc) {
+    // Conversão em ponto fixo (ver tds_kernel.h); tds_ppm_float_ref() é a referência
+    int32_t ppm_q16 = tds_ppm_q16_from_uv(uv, temp_cc);
+    return (float)ppm_q16 * (1.0f / 65536.0f);
+}
 
-    // Polinômio comum em exemplos de TDS (E-201-C/Gravity p.ex.), escalado por 0.5
-    float tds = (133.42f*comp_voltage*comp_voltage*comp_voltage
-              - 255.86f*comp_voltage*comp_voltage
-              + 857.39f*comp_voltage) * 0.5f;
+// Segundos desde o boot frio; o relógio do sistema segue o RTC durante o deep sleep
+static uint32_t now_s(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)tv.tv_sec;
+}
+
+// Idem em ms, p/ o TDMA
+static int64_t now_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
 
-    if (tds < 0) tds = 0;
-    if (out_voltage) *out_voltage = voltage;
-    return tds;
+// Timer do deep sleep com o jitter de MAC (nunca abaixo de 1 s); um lote
+// adiado p/ o slot TDMA antecipa o wake, sem jitter
+static uint64_t sleep_timer_us(uint32_t sleep_s) {
+    int64_t us = (int64_t)sleep_s * 1000000 + (int64_t)mac_jitter_ms(&s_mac, MAC_WAKE_JITTER_MS) * 1000;
+    if (s_wake_at_ms > 0) {
+        int64_t slot_us = (s_wake_at_ms - now_ms()) * 1000;
+        if (slot_us < us) return slot_us > 0 ? (uint64_t)slot_us : 1000ULL;
+    }
+    return us < 1000000 ? 1000000ULL : (uint64_t)us;
 }
 
-// Entra em deep-sleep pelo tempo configurado
+// Entra em deep-sleep por s_sleep_s (ajustado pelo agendador send-on-delta)
 static void go_to_sleep(void) {
-    ESP_LOGI(TAG, "Dormindo por %d seg...", SLEEP_SECONDS);
+    prof_begin(PROF_SLEEP);
+    ESP_LOGI(TAG, "Dormindo por %lu seg...", (unsigned long)s_sleep_s);
 
     esp_deep_sleep_disable_rom_logging(); // opcional: reduz logs da ROM ao acordar
 
-    // Habilita wake-up por tempo
-    ESP_ERROR_CHECK(esp_sleep_enable_timer_wakeup(SLEEP_US));
-
     // fecha ADC para economizar
     adc_deinit();
 
+#if CONFIG_ULP_COPROC_ENABLED
+    // ULP amostra a cada s_sleep_s; o timer fica só como rede de segurança
+    s_ulp_period_s = s_sleep_s;
+    s_ulp_armed_s = now_s();
+    esp_err_t err = ulp_sampler_init(ADC_UNIT_ID, ADC_CHANNEL, ADC_ATTEN_DB_11);
+    if (err == ESP_OK) err = ulp_sampler_arm(s_sleep_s, ULP_BATCH, s_last_raw, ULP_WAKE_DELTA_RAW);
+    if (err == ESP_OK) {
+        // O timer garante o boot completo (heartbeat ou lote pendente envelhecendo);
+        // lotes do ULP sem variação são resolvidos no wake stub
+        uint32_t backstop_s = SOD_HEARTBEAT_S;
+        if (reading_log_count() > 0) {
+            uint32_t age = reading_log_oldest_age_s(now_s());
+            uint32_t left = age < BATCH_MAX_AGE_S ? BATCH_MAX_AGE_S - age : 1;
+            if (left < backstop_s) backstop_s = left;
+        }
+        ESP_LOGI(TAG, "ULP armado: lote %d, janela %u +/- %d; timer %lu s", ULP_BATCH, s_last_raw,
+                 ULP_WAKE_DELTA_RAW, (unsigned long)backstop_s);
+        ESP_ERROR_CHECK(esp_sleep_enable_timer_wakeup(sleep_timer_us(backstop_s)));
+    } else {
+        ESP_LOGW(TAG, "ULP indisponível (%s); wake só por timer", esp_err_to_name(err));
+        ESP_ERROR_CHECK(esp_sleep_enable_timer_wakeup(sleep_timer_us(s_sleep_s)));
+    }
+#else
+    // Habilita wake-up por tempo
+    ESP_ERROR_CHECK(esp_sleep_enable_timer_wakeup(sleep_timer_us(s_sleep_s)));
+#endif
+
+    prof_end(PROF_SLEEP);
+    prof_commit();
+    ESP_LOGI(TAG, "Wake completo: %lu us até dormir", (unsigned long)wake_stub_awake_us());
+    wake_stub_before_sleep();
+
     // consumo típico ~5–20 µA (placa-dependente)
     esp_deep_sleep_start();
 }
 
-// Reenvia o mesmo pacote várias vezes por ~TX_BURST_WINDOW_MS (para confiabilidade)
-static void lora_send_burst(const uint8_t *buf, int len) {
-    uint32_t start = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
-    while (((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS) - start) < TX_BURST_WINDOW_MS) {
-        lora_send_packet(buf, len); // envio não-bloqueante (depende da lib)
-        vTaskDelay(pdMS_TO_TICKS(TX_BURST_GAP_MS));
+// true se ainda cabem toa_us no ar dentro do duty cycle
+static bool duty_allows(uint32_t toa_us) {
+#if TX_DUTY_PPM
+    uint32_t now = now_s();
+    uint64_t drain = now >= s_duty_t_s ? (uint64_t)(now - s_duty_t_s) * TX_DUTY_PPM : 0; // s * ppm = us
+    s_duty_used_us = drain >= s_duty_used_us ? 0 : s_duty_used_us - (uint32_t)drain;
+    s_duty_t_s = now;
+    return (uint64_t)s_duty_used_us + toa_us <= (uint64_t)TX_DUTY_WINDOW_S * TX_DUTY_PPM;
+#else
+    (void)toa_us;
+    return true;
+#endif
+}
+
+// Transmite um pacote e contabiliza o tempo no ar (duty cycle e modelo de energia).
+// A lib espera o TxDone em polling de 1 tick, então a duração da chamada erra
+// até 10 ms; o tempo no ar vem da fórmula com o PHY configurado. Entre as
+// leituras do polling a task está em vTaskDelay: com tickless idle a CPU dorme
+static void radio_tx(const uint8_t *buf, int len) {
+    uint32_t toa = lora_time_on_air_us(len);
+    lora_send_packet(buf, len);
+    s_tx_air_us += toa;
+    s_tx_packets++;
+    s_duty_used_us += toa;
+    s_radio_wait_us += toa;
+}
+
+// Janela de RX p/ o ACK: reação do receptor + tempo no ar do ACK (com ADR e TDMA)
+static uint32_t ack_window_ms(void) {
+    return ACK_TURNAROUND_MS + (lora_time_on_air_us(PAYLOAD_ACK_TDMA_LEN) + 999) / 1000;
+}
+
+// Sincroniza com a fase que o receptor carimbou no início do TX de um
+// ACK/beacon de len bytes recebido em t_rx (a fase lá já andou o tempo no ar)
+static void tdma_observe(const payload_tdma_t *t, int slot, int len, int64_t t_rx) {
+#if TX_USE_TDMA
+    uint32_t phase = t->phase_ms + (lora_time_on_air_us(len) + 500) / 1000;
+    int32_t err = tdma_sync_observe(&s_tdma, t_rx, phase, t->slot_ms, t->nslots, slot);
+    ESP_LOGI(TAG, "TDMA: sync %u (slot %u/%u, erro %ld ms, drift %ld ppm)", s_tdma.syncs, s_tdma.slot,
+             s_tdma.nslots, (long)err, (long)s_tdma.drift_ppm);
+#else
+    (void)t; (void)slot; (void)len; (void)t_rx;
+#endif
+}
+
+// true se ainda cabe need_ms antes do fim do slot TDMA (sempre, em ALOHA)
+static bool slot_fits(uint32_t need_ms) {
+    return s_slot_end_ms == 0 || now_ms() + need_ms <= s_slot_end_ms;
+}
+
+#if TX_USE_ACK
+// Janela de RX logo após o TX: true se chegou o ACK deste nó/seq
+static bool wait_ack(uint16_t seq, uint32_t window_ms) {
+    uint8_t rx[LORA_MAX_PAYLOAD];
+    bool acked = false;
+    TickType_t start = xTaskGetTickCount();
+    TickType_t window = pdMS_TO_TICKS(window_ms);
+    lora_dio_arm();
+    lora_receive();
+    while (!acked) {
+        TickType_t elapsed = xTaskGetTickCount() - start; // lido uma vez: sem wrap no resto
+        if (elapsed >= window) break;
+        if (!lora_received()) {
+            // dorme até o RxDone (DIO0) ou o fim da janela; sem ISR, 1 tick
+            lora_dio_wait(window - elapsed);
+            continue;
+        }
+        int64_t t_rx = now_ms();
+        int n = lora_receive_packet(rx, sizeof(rx));
+        payload_ack_t ack;
+        payload_tdma_t beacon;
+        acked = n > 0 && payload_ack_parse(rx, n, &ack) && ack.node_id == s_node_id && ack.seq == seq;
+        if (acked) {
+            s_ack = ack;
+            if (ack.has_tdma) tdma_observe(&ack.tdma, ack.slot, n, t_rx);
+        } else {
+            if (n > 0 && payload_beacon_parse(rx, n, &beacon)) tdma_observe(&beacon, -1, n, t_rx);
+            lora_dio_arm(); // pacote de outro nó: segue ouvindo
+            lora_receive();
+        }
     }
+    lora_idle();
+    return acked;
 }
+#endif
 
-void app_main(void) {
-    // Motivo do wake-up (primeiro boot, timer, etc.)
-    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
-    if (cause == ESP_SLEEP_WAKEUP_TIMER) {
-        ESP_LOGI(TAG, "Acordei pelo TIMER");
-    } else if (cause == ESP_SLEEP_WAKEUP_UNDEFINED) {
-        ESP_LOGI(TAG, "Boot frio (primeira inicialização)");
-    } else {
-        ESP_LOGI(TAG, "Acordei por outra causa: %d", (int)cause);
+// Intervalo entre pacotes do mesmo quadro; com ACK o começo é a janela de RX.
+// true = quadro confirmado, pode parar
+static bool tx_gap(uint16_t seq, bool last) {
+    bool acked = false;
+    int64_t t0 = esp_timer_get_time();
+#if TX_USE_ACK
+    uint32_t window_ms = ack_window_ms();
+    acked = wait_ack(seq, window_ms);
+    uint32_t gap_ms = TX_BURST_GAP_MS + mac_rand(&s_mac, MAC_GAP_JITTER_MS);
+    if (!acked && !last && window_ms < gap_ms) vTaskDelay(pdMS_TO_TICKS(gap_ms - window_ms));
+#else
+    if (!last) vTaskDelay(pdMS_TO_TICKS(TX_BURST_GAP_MS + mac_rand(&s_mac, MAC_GAP_JITTER_MS)));
+#endif
+    s_radio_wait_us += (uint32_t)(esp_timer_get_time() - t0);
+    return acked;
+}
+
+// Reenvia o mesmo pacote enquanto a próxima cópia terminar dentro de
+// TX_BURST_WINDOW_MS (e do slot TDMA; ao menos uma); true se confirmado por ACK
+static bool lora_send_burst(const uint8_t *buf, int len, uint16_t seq) {
+    uint32_t toa_ms = (lora_time_on_air_us(len) + 999) / 1000;
+    uint32_t start = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    do {
+        radio_tx(buf, len);
+        if (tx_gap(seq, false)) return true;
+    } while (((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS) - start) + toa_ms <= TX_BURST_WINDOW_MS
+             && slot_fits(toa_ms));
+    return false;
+}
+
+// Tempo no ar do pior caso de um quadro (sem ACK): o que o duty cycle reserva
+static uint32_t frame_airtime_us(int len, int m) {
+#if TX_USE_FEC
+    int k = (len + FEC_MIN_SHARD - 1) / FEC_MIN_SHARD;
+    if (k < 1) k = 1;
+    if (k > FEC_K) k = FEC_K;
+    return (uint32_t)(k + m) * lora_time_on_air_us(PAYLOAD_FEC_HDR_LEN + (len + k - 1) / k);
+#else
+    (void)m;
+    uint32_t toa = lora_time_on_air_us(len);
+    uint32_t slot_ms = (toa + 999) / 1000 + TX_BURST_GAP_MS;
+    return (TX_BURST_WINDOW_MS / slot_ms + 1) * toa;
+#endif
+}
+
+// Manda o quadro como k shards de dados + m (<= FEC_M) de paridade, um pacote
+// cada (dados primeiro), até onde couber no slot TDMA; true se confirmado por ACK
+static bool lora_send_fec(const uint8_t *frame, int len, uint16_t seq, int m) {
+    static uint8_t shards[FEC_K + FEC_M][FEC_MAX_FRAME];
+    int k = (len + FEC_MIN_SHARD - 1) / FEC_MIN_SHARD;
+    if (k < 1) k = 1;
+    if (k > FEC_K) k = FEC_K;
+    int shard_len = (len + k - 1) / k;
+
+    uint8_t *ptr[FEC_K + FEC_M];
+    for (int i = 0; i < k + m; i++) ptr[i] = shards[i];
+    for (int j = 0; j < k; j++) {
+        int off = j * shard_len;
+        int n = len - off < shard_len ? len - off : shard_len;
+        memset(shards[j], 0, shard_len);
+        if (n > 0) memcpy(shards[j], frame + off, n);
     }
+    fec_encode((const uint8_t *const *)ptr, ptr + k, k, m, shard_len);
 
-    // Init LoRa
-    if (lora_init() == 0) { // precisa detectar o SX127x
-        ESP_LOGE(TAG, "SX127x não encontrado");
-        go_to_sleep(); // falhou? dorme e tenta denovo no próximo ciclo
+    payload_fec_hdr_t h = {
+        .node_id = s_node_id, .seq = seq, .k = (uint8_t)k, .m = (uint8_t)m, .frame_len = (uint16_t)len,
+    };
+    uint8_t pkt[LORA_MAX_PAYLOAD];
+    uint32_t toa_ms = (lora_time_on_air_us(PAYLOAD_FEC_HDR_LEN + shard_len) + 999) / 1000;
+    for (int i = 0; i < k + m; i++) {
+        if (i > 0 && !slot_fits(toa_ms)) {
+            ESP_LOGW(TAG, "TDMA: fim do slot após %d de %d shards", i, k + m);
+            break;
+        }
+        h.idx = (uint8_t)i;
+        int plen = payload_fec_write(pkt, sizeof(pkt), &h, shards[i], shard_len);
+        radio_tx(pkt, plen);
+        if (tx_gap(seq, i + 1 == k + m)) return true;
     }
+    return false;
+}
 
+// PHY: precisa bater com o receptor (o SF pode vir do ADR)
+static void radio_phy(int *cr, int *bw, int *sf) {
+    *cr = 1; *bw = 7; *sf = 9;
+#if CONFIG_ADVANCED
+    *cr = CONFIG_CODING_RATE;
+    *bw = CONFIG_BANDWIDTH;
+    *sf = CONFIG_SF_RATE;
+#endif
+    if (s_adr.sf) *sf = s_adr.sf;
+}
+
+// Escreve frequência/CRC/PHY e confere o PHY lendo de volta os registradores
+static bool radio_configure(void) {
 // Frequência (garanta que bate com o receptor)
 #if CONFIG_915MHZ
     lora_set_frequency(915e6);
@@ -124,38 +533,412 @@ void app_main(void) {
 
     lora_enable_crc(); // habilita CRC no payload (melhor integridade)
 
-    // PHY: precisa bater com o receptor
-    int cr = 1, bw = 7, sf = 9;
-#if CONFIG_ADVANCED
-    cr = CONFIG_CODING_RATE;
-    bw = CONFIG_BANDWIDTH;
-    sf = CONFIG_SF_RATE;
-#endif
+    int cr, bw, sf;
+    radio_phy(&cr, &bw, &sf);
     lora_set_coding_rate(cr);
     lora_set_bandwidth(bw);
     lora_set_spreading_factor(sf);
+    lora_set_tx_power(s_adr.tx_dbm ? s_adr.tx_dbm : TX_POWER_DBM);
+    lora_set_dio_mapping(0, 0); // DIO0 = RxDone em RX, TxDone em TX
     // (Opcional) lora_set_sync_word(0x12);
 
-    // Init ADC
+    return lora_get_coding_rate() == cr && lora_get_bandwidth() == bw
+        && lora_get_spreading_factor() == sf;
+}
+
+// Põe o SX127x em sleep (~0,2 uA, registradores retidos) e segura RST/NSS em
+// nível alto durante o deep sleep; sem isso o rádio fica em standby (~1,6 mA)
+// ou é resetado pelos pinos flutuando
+static void radio_sleep(void) {
+    lora_dio_deinit(); // o wakeup por GPIO é só do light sleep
+    lora_sleep();
+    gpio_hold_en(CONFIG_RST_GPIO);
+    gpio_hold_en(CONFIG_CS_GPIO);
+    gpio_deep_sleep_hold_en();
+}
+
+// Inicializa o SX127x e configura o PHY; false se o rádio não respondeu.
+// lora_init() sempre reseta o chip e é quem abre o SPI da lib, então não dá
+// p/ aproveitar os registradores retidos no sleep; se o read-back do PHY não
+// bater, reseta e configura mais uma vez
+static bool radio_init(void) {
+    // libera RST/NSS presos pelo radio_sleep() do ciclo anterior
+    gpio_hold_dis(CONFIG_RST_GPIO);
+    gpio_hold_dis(CONFIG_CS_GPIO);
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (lora_init() == 0) { // precisa detectar o SX127x
+            ESP_LOGE(TAG, "SX127x não encontrado");
+            return false;
+        }
+        if (radio_configure()) {
+            esp_err_t err = lora_dio_init(LORA_DIO0_GPIO);
+            if (err != ESP_OK) ESP_LOGW(TAG, "DIO0 sem ISR (%s); ACK por polling", esp_err_to_name(err));
+            return true;
+        }
+        ESP_LOGW(TAG, "PHY do SX127x não confere (cr=%d bw=%d sf=%d); reiniciando",
+                 lora_get_coding_rate(), lora_get_bandwidth(), lora_get_spreading_factor());
+    }
+    radio_sleep(); // não transmite configurado errado; pelo menos não gasta dormindo
+    return false;
+}
+
+// Aplica o ADR depois de cada quadro: adota a recomendação do ACK (o receptor
+// já troca de SF ao mandá-lo) ou, após ADR_MISS_LIMIT quadros sem ACK, volta ao padrão
+static void adr_feedback(bool acked) {
+#if TX_USE_ACK && TX_USE_ADR
+    radio_adr_t prev = s_adr;
+    if (acked) {
+        s_adr.misses = 0;
+        if (s_ack.has_adr && s_ack.sf >= 6 && s_ack.sf <= 12 && s_ack.tx_dbm >= 2 && s_ack.tx_dbm <= 17) {
+            s_adr.sf = s_ack.sf;
+            s_adr.tx_dbm = s_ack.tx_dbm;
+        }
+    } else if ((s_adr.sf || s_adr.tx_dbm) && ++s_adr.misses >= ADR_MISS_LIMIT) {
+        ESP_LOGW(TAG, "ADR: %d quadros sem ACK; voltando ao PHY padrão", s_adr.misses);
+        s_adr = (radio_adr_t){ 0 };
+    }
+    if (prev.sf == s_adr.sf && prev.tx_dbm == s_adr.tx_dbm) return;
+    if (!radio_configure()) ESP_LOGW(TAG, "ADR: PHY não confere após reconfigurar");
+    ESP_LOGI(TAG, "ADR: SF%d, %d dBm (%lu us p/ 64 bytes)", lora_get_spreading_factor(),
+             s_adr.tx_dbm ? s_adr.tx_dbm : TX_POWER_DBM, (unsigned long)lora_time_on_air_us(64));
+#else
+    (void)acked;
+#endif
+}
+
+// Resumo do perfil por fase p/ o uplink (0,1 ms); false se não há ciclos
+static bool profile_for_uplink(payload_profile_t *p) {
+    uint32_t cycles = prof_cycles();
+    if (cycles == 0) return false;
+    p->cycles = cycles > UINT16_MAX ? UINT16_MAX : (uint16_t)cycles;
+    p->n = PROF_PHASE_COUNT;
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) {
+        const prof_stat_t *st = prof_stat((prof_phase_t)i);
+        uint32_t avg = st->n ? (uint32_t)(st->sum_us / st->n) : 0;
+        uint32_t avg_t = (avg + 50) / 100, max_t = (st->max_us + 50) / 100;
+        p->avg[i] = avg_t > UINT16_MAX ? UINT16_MAX : (uint16_t)avg_t;
+        p->max[i] = max_t > UINT16_MAX ? UINT16_MAX : (uint16_t)max_t;
+    }
+    return true;
+}
+
+// Monta um quadro binário (payload.h) a partir da mais antiga, com quantas
+// leituras couberem em cap bytes, comprimidas em colunas delta/varint.
+// Devolve o tamanho; *consumed = nº de leituras
+static int encode_batch(uint8_t *buf, int cap, uint32_t now, const payload_profile_t *prof,
+                        int *consumed) {
+    // temperatura/salinidade vão no quadro se alguma leitura tiver
+    uint8_t flags = 0;
+    for (int i = 0; i < reading_log_count(); i++) {
+        if (reading_log_peek(i)->temp_cc != READING_NO_TEMP) {
+            flags = PAYLOAD_F_TEMP;
+            break;
+        }
+    }
+    payload_writer_t w;
+    *consumed = 0;
+    if (!payload_writer_init(&w, buf, cap, s_node_id, s_tx_seq, flags)) return 0;
+    if (prof) payload_writer_profile(&w, prof);
+
+    payload_reading_t pr[READING_LOG_CAPACITY];
+    int total = reading_log_count();
+    for (int i = 0; i < total; i++) {
+        const reading_t *r = reading_log_peek(i);
+        uint32_t age = now > r->t_s ? now - r->t_s : 0;
+        pr[i] = (payload_reading_t){
+            .age_s     = age > UINT16_MAX ? UINT16_MAX : (uint16_t)age,
+            .tds_ppm   = r->tds_ppm,
+            .mv        = r->mv,
+            .temp_cc   = r->temp_cc, // READING_NO_TEMP == PAYLOAD_NO_TEMP
+            .sal_milli = r->sal_milli,
+        };
+    }
+    int n = payload_writer_add_packed(&w, pr, total);
+    *consumed = n;
+    return n > 0 ? payload_writer_finish(&w) : 0;
+}
+
+// Esvazia a fila em um ou mais quadros (FEC ou repetição no burst; no slot
+// TDMA só um quadro, com menos paridade); o primeiro leva o resumo do perfil por fase
+static void send_batches(uint32_t now) {
+#if TX_USE_FEC
+    uint8_t buf[FEC_MAX_FRAME];
+#else
+    uint8_t buf[LORA_MAX_PAYLOAD];
+#endif
+    payload_profile_t prof;
+    bool with_prof = profile_for_uplink(&prof);
+    int m = s_slot_end_ms > 0 ? TDMA_FEC_M : FEC_M;
+    while (reading_log_count() > 0) {
+        int n = 0;
+        int len = encode_batch(buf, sizeof(buf), now, with_prof ? &prof : NULL, &n);
+        if (len <= 0) break;
+        uint32_t need_us = frame_airtime_us(len, m);
+        if (!duty_allows(need_us)) {
+            // as leituras ficam na fila; o balde escoa até o próximo lote
+            ESP_LOGW(TAG, "Duty cycle: %lu us no balde, quadro pede %lu us; adiado",
+                     (unsigned long)s_duty_used_us, (unsigned long)need_us);
+            break;
+        }
+        uint32_t pkts = s_tx_packets;
+#if TX_USE_FEC
+        bool acked = lora_send_fec(buf, len, s_tx_seq, m);
+#else
+        bool acked = lora_send_burst(buf, len, s_tx_seq); // envia várias vezes na janela de burst
+#endif
+        ESP_LOGI(TAG, "LoRa sent (seq %u, %d leituras, %d bytes%s): %s após %lu pacotes",
+                 s_tx_seq, n, len, with_prof ? ", com perfil" : "",
+                 acked ? "ACK" : (TX_USE_ACK ? "sem ACK" : "sem confirmação"),
+                 (unsigned long)(s_tx_packets - pkts));
+        adr_feedback(acked);
+        s_tx_seq++;
+        reading_log_drop(n);
+        if (with_prof) {
+            with_prof = false;
+            prof_reset_stats(); // próximo resumo cobre os ciclos a partir daqui
+        }
+        if (s_slot_end_ms > 0) break; // o resto espera o próximo slot
+    }
+    int lost = lora_packet_lost(); // se a lib suportar estatística
+    if (lost) ESP_LOGW(TAG, "packets lost: %d", lost);
+}
+
+// Ciclo médio p/ o modelo de energia: fases sem rádio pela média do perfil
+// (wakes desde o último uplink) e o lote = esses wakes + o atual
+static void energy_cycle_from_prof(energy_cycle_t *ec) {
+    static const prof_phase_t awake[] = {
+        PROF_BOOT, PROF_ADC_INIT, PROF_PROBE, PROF_TEMP, PROF_PROCESS, PROF_SLEEP,
+    };
+    memset(ec, 0, sizeof(*ec));
+    for (int i = 0; i < (int)(sizeof(awake) / sizeof(awake[0])); i++) {
+        const prof_stat_t *st = prof_stat(awake[i]);
+        uint32_t us = st->n ? (uint32_t)(st->sum_us / st->n) : prof_current_us(awake[i]);
+        ec->awake_us += us;
+        if (awake[i] == PROF_PROBE) ec->adc_us = us;
+    }
+    ec->sleep_s = s_sleep_s;
+    ec->cycles_per_tx = prof_cycles() + 1;
+}
+
+// Completa o ciclo com o rádio deste wake (medido; tempo no ar pela fórmula) e loga a estimativa
+static void log_energy_estimate(energy_cycle_t *ec) {
+    ec->radio_on_us = prof_current_us(PROF_RADIO_INIT) + prof_current_us(PROF_TX);
+    ec->cpu_sleep_us = s_radio_wait_us;
+    ec->tx_packets = s_tx_packets;
+    ec->toa_us = s_tx_packets ? s_tx_air_us / s_tx_packets : 0;
+    energy_estimate_t e = energy_estimate(&s_energy_profile, ec);
+    ESP_LOGI(TAG, "Energia: ciclo %.1f s, %.1f uAh (rádio %.0f%%, %lu pacotes x %lu us no ar, lote %lu) "
+             "-> %.2f mAh/dia, ~%.0f dias de bateria",
+             e.cycle_s, e.cycle_uah, e.tx_share * 100.0f, (unsigned long)ec->tx_packets,
+             (unsigned long)ec->toa_us, (unsigned long)ec->cycles_per_tx, e.mah_per_day, e.life_days);
+}
+
+// Calcula TDS/salinidade de uma leitura, passa pelo send-on-delta e enfileira
+static void process_reading(uint32_t uv, int32_t temp_cc, bool temp_measured, uint32_t t_s) {
+    float tds = tds_from_uv(uv, temp_cc);
+
+    // Salinidade prática PSS-78 (só faz sentido com temperatura medida)
+    float temp_c = temp_cc / 100.0f;
+    float sal = salinity_pss78(salinity_cond_from_tds(tds, temp_c), temp_c);
+    ESP_LOGI(TAG, "TDS=%.0f ppm S_P=%.3f S_R=%.3f g/kg (t=%.2f °C)",
+             tds, sal, salinity_teos10_sr(sal), temp_c);
+
+    // Send-on-delta: decide se a leitura vale ser reportada e o próximo sono
+    report_decision_t dec = report_sched_step(&s_report, &s_report_cfg, (int32_t)(tds + 0.5f), t_s);
+    s_sleep_s = dec.sleep_s;
+
+    // Guarda na fila em RTC; o rádio só liga quando o lote estiver pronto
+    reading_t r = {
+        .t_s       = t_s,
+        .tds_ppm   = (uint16_t)(tds + 0.5f),
+        .mv        = (uint16_t)((uv + 500) / 1000),
+        .temp_cc   = temp_measured ? (int16_t)temp_cc : READING_NO_TEMP,
+        .sal_milli = temp_measured ? (uint16_t)(sal * 1000.0f + 0.5f) : 0,
+    };
+    if (dec.reason == REPORT_SKIP) {
+        ESP_LOGI(TAG, "TDS dentro de +/-%d ppm do último reporte; não enfileirado", SOD_DELTA_PPM);
+    } else if (!reading_log_push(&r)) {
+        ESP_LOGW(TAG, "Fila cheia: leitura mais antiga descartada");
+    }
+
+}
+
+// Espera a vez de transmitir, com o rádio desligado (CPU em light sleep).
+// Com TDMA sincronizado: até o slot do nó, ou, se faltar muito, adia o lote e
+// agenda o wake p/ pouco antes do slot (false). Sem sincronismo: ALOHA com
+// o offset do nó no boot frio + jitter
+static bool channel_wait(bool cold_boot) {
+    s_slot_end_ms = 0;
+#if TX_USE_TDMA
+    int64_t now = now_ms();
+    if (tdma_sync_valid(&s_tdma, now, TDMA_SYNC_MAX_S * 1000)) {
+        uint32_t wait_ms = tdma_sync_wait_ms(&s_tdma, now, TDMA_GUARD_MS);
+        if (wait_ms > TDMA_AWAKE_WAIT_MS) {
+            s_tdma_tx_due = true;
+            s_wake_at_ms = now + wait_ms - TDMA_WAKE_LEAD_MS;
+            return false;
+        }
+        ESP_LOGI(TAG, "TDMA: slot %u em %lu ms", s_tdma.slot, (unsigned long)wait_ms);
+        vTaskDelay(pdMS_TO_TICKS(wait_ms));
+        s_tdma_tx_due = false;
+        now = now_ms();
+        s_slot_end_ms = now + tdma_sync_slot_left_ms(&s_tdma, now);
+        return true;
+    }
+#endif
+    s_tdma_tx_due = false;
+    // desalinha dos outros emissores
+    uint32_t wait_ms = (cold_boot ? mac_slot_offset_ms(s_node_id, MAC_SLOT_SPAN_MS) : 0)
+                     + mac_rand(&s_mac, MAC_TX_JITTER_MS);
+    ESP_LOGI(TAG, "MAC: TX em %lu ms", (unsigned long)wait_ms);
+    vTaskDelay(pdMS_TO_TICKS(wait_ms));
+    return true;
+}
+
+// Identidade do nó: NODE_ID fixo ou os 4 bytes baixos do MAC de fábrica
+// (únicos entre placas do mesmo OUI); o receptor reserva o 0
+static void node_id_init(void) {
+    s_node_id = NODE_ID;
+#if NODE_ID == 0
+    uint8_t mac[6];
+    if (esp_efuse_mac_get_default(mac) == ESP_OK) {
+        s_node_id = (uint32_t)mac[2] << 24 | (uint32_t)mac[3] << 16 | (uint32_t)mac[4] << 8 | mac[5];
+    }
+    if (s_node_id == 0) s_node_id = 1;
+#endif
+    ESP_LOGI(TAG, "node_id 0x%08lx", (unsigned long)s_node_id);
+}
+
+// Light sleep automático entre os eventos do wake (ver PM_*)
+static void pm_init(void) {
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm = {
+        .max_freq_mhz       = PM_MAX_FREQ_MHZ,
+        .min_freq_mhz       = PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = true,
+    };
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK) ESP_LOGW(TAG, "Light sleep automático indisponível: %s", esp_err_to_name(err));
+#endif
+}
+
+void app_main(void) {
+    // Motivo do wake-up (primeiro boot, timer, etc.)
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    if (cause == ESP_SLEEP_WAKEUP_TIMER) {
+        ESP_LOGI(TAG, "Acordei pelo TIMER");
+    } else if (cause == ESP_SLEEP_WAKEUP_ULP) {
+        ESP_LOGI(TAG, "Acordei pelo ULP");
+    } else if (cause == ESP_SLEEP_WAKEUP_UNDEFINED) {
+        ESP_LOGI(TAG, "Boot frio (primeira inicialização)");
+    } else {
+        ESP_LOGI(TAG, "Acordei por outra causa: %d", (int)cause);
+    }
+    bool cold_boot = cause == ESP_SLEEP_WAKEUP_UNDEFINED;
+
+#if CONFIG_ULP_COPROC_ENABLED
+    // No wake pelo timer o ULP seguiria amostrando no ADC1 junto com o
+    // burst das CPUs; go_to_sleep() rearma
+    if (!cold_boot) ulp_sampler_stop();
+#endif
+
+    // Perfil por fase: o boot conta do wake (relógio RTC, via stub) até aqui;
+    // no boot frio só dá p/ medir a partir do startup do app
+    prof_init(cold_boot);
+    uint32_t boot_us = wake_stub_awake_us();
+    prof_add_us(PROF_BOOT, boot_us ? boot_us : (uint32_t)esp_timer_get_time());
+
+    // Tempos acordar->dormir dos dois caminhos (stub e boot completo)
+    wake_stub_stats_t ws;
+    wake_stub_take_stats(cold_boot, &ws);
+    if (!cold_boot) {
+        ESP_LOGI(TAG, "Wake stub: %lu wakes sem boot (último %lu us, máx %lu us); wake completo anterior %lu us",
+                 (unsigned long)ws.stub_wakes, (unsigned long)ws.stub_last_us,
+                 (unsigned long)ws.stub_max_us, (unsigned long)ws.full_last_us);
+    }
+
+    reading_log_init(cold_boot);
+    if (cold_boot) report_sched_reset(&s_report);
+    if (cold_boot) {
+        node_id_init();
+        s_tx_seq = (uint16_t)esp_random(); // o receptor vê o salto e ressincroniza a deduplicação
+        mac_sched_init(&s_mac, s_node_id, esp_random());
+        tdma_sync_reset(&s_tdma);
+    }
+    pm_init();
+
+    // Conversão de temperatura: sobrepõe só o init do ADC e o burst
+    temp_start();
+
+    // Init ADC (no modo contínuo o DMA já começa a encher o buffer)
+    prof_begin(PROF_ADC_INIT);
     adc_init();
 
-    // Medir e enviar (single-shot)
-    float v = 0.0f;
-    float tds = read_tds_ppm(&v);
+    // Calibração eFuse: só no boot frio; wakes por timer/ULP usam a tabela em RTC
+    adc_cal_init(ADC_UNIT_ID, ADC_ATTEN_DB_11,
+                 cause != ESP_SLEEP_WAKEUP_TIMER && cause != ESP_SLEEP_WAKEUP_ULP);
+    prof_end(PROF_ADC_INIT);
 
-    // Monta payload ASCII no formato esperado pelo receptor: "TD,<ppm>,<volt>"
-    uint8_t buf[64];
-    int len = snprintf((char*)buf, sizeof(buf), "TD,%.0f,%.2f", tds, v);
-    if (len < 0) len = 0;
+    // Medir; a temperatura só espera o que faltar da conversão
+    prof_begin(PROF_PROBE);
+    uint32_t uv = read_probe_uv();
+    adc_deinit(); // ADC não é mais usado neste wake
+    prof_end(PROF_PROBE);
+    prof_begin(PROF_TEMP);
+    bool temp_measured;
+    int32_t temp_cc = read_temperature_cc(&temp_measured);
+    prof_end(PROF_TEMP);
+    uint32_t now = now_s();
 
-    if (len > 0) {
-        lora_send_burst(buf, len); // envia várias vezes na janela de burst
-        ESP_LOGI(TAG, "LoRa sent: %s", (char*)buf);
-        int lost = lora_packet_lost(); // se a lib suportar estatística
-        if (lost) ESP_LOGW(TAG, "packets lost: %d", lost);
+    prof_begin(PROF_PROCESS);
+
+#if CONFIG_ULP_COPROC_ENABLED
+    // Médias que o ULP juntou durante o sono (mais antiga primeiro)
+    if (cause == ESP_SLEEP_WAKEUP_ULP || cause == ESP_SLEEP_WAKEUP_TIMER) {
+        int n = ulp_sampler_count();
+        ESP_LOGI(TAG, "ULP: %d médias em RTC (período %lu s)", n, (unsigned long)s_ulp_period_s);
+        // tempo pelo arm: a média i do lote saiu (i + 1) períodos depois, e
+        // cada lote descartado no stub empurra ULP_BATCH períodos (o stub
+        // religa o timer logo após a última média). No wake pelo timer a
+        // última média pode ter quase um período
+        uint32_t first = ws.stub_wakes * ULP_BATCH + 1;
+        for (int i = 0; i < n; i++) {
+            uint32_t t = s_ulp_armed_s + (first + (uint32_t)i) * s_ulp_period_s;
+            uint32_t ulp_uv = adc_cal_raw_q4_to_uv((uint32_t)ulp_sampler_get(i) << 4);
+            process_reading(ulp_uv, temp_cc, temp_measured, t < now ? t : now);
+        }
     }
+#endif
 
-    vTaskDelay(pdMS_TO_TICKS(100)); // pequena folga p/ terminar TX e logs
+    process_reading(uv, temp_cc, temp_measured, now);
+    prof_end(PROF_PROCESS);
+
+    int pending = reading_log_count();
+    uint32_t oldest_age = reading_log_oldest_age_s(now);
+    bool tx_due = s_tdma_tx_due || cold_boot || pending >= BATCH_SIZE || oldest_age >= BATCH_MAX_AGE_S;
+    if (pending > 0 && tx_due && channel_wait(cold_boot)) {
+        energy_cycle_t ec;
+        energy_cycle_from_prof(&ec); // antes do send_batches zerar o perfil
+
+        prof_begin(PROF_RADIO_INIT);
+        bool radio_ok = radio_init();
+        prof_end(PROF_RADIO_INIT);
+        if (radio_ok) {
+            prof_begin(PROF_TX);
+            send_batches(now);
+            vTaskDelay(pdMS_TO_TICKS(100)); // pequena folga p/ terminar TX e logs
+            radio_sleep();
+            prof_end(PROF_TX);
+            log_energy_estimate(&ec);
+        }
+        // rádio falhou? as leituras ficam na fila p/ o próximo ciclo
+    } else if (s_wake_at_ms > 0) {
+        ESP_LOGI(TAG, "Lote de %d leituras adiado p/ o slot TDMA", pending);
+    } else {
+        ESP_LOGI(TAG, "Leitura guardada (%d/%d, mais antiga há %lu s); rádio não ligado",
+                 pending, BATCH_SIZE, (unsigned long)oldest_age);
+    }
 
     // Volta a dormir
     go_to_sleep();
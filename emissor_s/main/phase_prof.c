@@ -0,0 +1,107 @@
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "phase_prof.h"
+
+#define TAG "PROF"
+
+#define PROF_MAGIC  0x50524F46u // "PROF"
+
+static const char *const s_names[PROF_PHASE_COUNT] = {
+    "boot", "adc_init", "probe", "temp", "process", "radio_init", "tx", "sleep",
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t cycles;                          // wakes acumulados em st[]
+    uint32_t last_us[PROF_PHASE_COUNT];       // último ciclo (0 = não rodou)
+    uint32_t last_cpu[PROF_PHASE_COUNT];      // idem, em ciclos de CPU
+    prof_stat_t st[PROF_PHASE_COUNT];
+} prof_rtc_t;
+
+static RTC_DATA_ATTR prof_rtc_t s_prof;
+
+// Ciclo em andamento (RAM comum; vai p/ a RTC no commit)
+static int64_t  s_t0_us[PROF_PHASE_COUNT];
+static uint32_t s_t0_cpu[PROF_PHASE_COUNT];
+static uint32_t s_cur_us[PROF_PHASE_COUNT];
+static uint32_t s_cur_cpu[PROF_PHASE_COUNT];
+static uint32_t s_ran; // bit por fase
+
+void prof_reset_stats(void) {
+    s_prof.cycles = 0;
+    memset(s_prof.st, 0, sizeof(s_prof.st));
+}
+
+void prof_init(bool cold_boot) {
+    if (cold_boot || s_prof.magic != PROF_MAGIC) {
+        memset(&s_prof, 0, sizeof(s_prof));
+        s_prof.magic = PROF_MAGIC;
+    }
+    memset(s_cur_us, 0, sizeof(s_cur_us));
+    memset(s_cur_cpu, 0, sizeof(s_cur_cpu));
+    s_ran = 0;
+}
+
+void prof_begin(prof_phase_t ph) {
+    if ((unsigned)ph >= PROF_PHASE_COUNT) return;
+    s_t0_cpu[ph] = (uint32_t)esp_cpu_get_cycle_count();
+    s_t0_us[ph] = esp_timer_get_time();
+}
+
+void prof_end(prof_phase_t ph) {
+    if ((unsigned)ph >= PROF_PHASE_COUNT) return;
+    int64_t now = esp_timer_get_time();
+    uint32_t cpu = (uint32_t)esp_cpu_get_cycle_count();
+    s_cur_us[ph] += (uint32_t)(now - s_t0_us[ph]);
+    s_cur_cpu[ph] += cpu - s_t0_cpu[ph]; // aritmética modular cobre o wrap
+    s_ran |= 1u << ph;
+}
+
+void prof_add_us(prof_phase_t ph, uint32_t us) {
+    if ((unsigned)ph >= PROF_PHASE_COUNT) return;
+    s_cur_us[ph] += us;
+    s_ran |= 1u << ph;
+}
+
+void prof_commit(void) {
+    s_prof.cycles++;
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) {
+        if (!(s_ran & (1u << i))) {
+            s_prof.last_us[i] = 0;
+            s_prof.last_cpu[i] = 0;
+            continue;
+        }
+        uint32_t us = s_cur_us[i];
+        s_prof.last_us[i] = us;
+        s_prof.last_cpu[i] = s_cur_cpu[i];
+
+        prof_stat_t *st = &s_prof.st[i];
+        if (st->n == 0 || us < st->min_us) st->min_us = us;
+        if (us > st->max_us) st->max_us = us;
+        st->sum_us += us;
+        st->n++;
+        ESP_LOGI(TAG, "%-10s %7lu us %9lu ciclos | min %lu méd %lu máx %lu (n=%lu)",
+                 s_names[i], (unsigned long)us, (unsigned long)s_cur_cpu[i],
+                 (unsigned long)st->min_us, (unsigned long)(st->sum_us / st->n),
+                 (unsigned long)st->max_us, (unsigned long)st->n);
+    }
+}
+
+const prof_stat_t *prof_stat(prof_phase_t ph) {
+    if ((unsigned)ph >= PROF_PHASE_COUNT) return NULL;
+    return &s_prof.st[ph];
+}
+
+uint32_t prof_current_us(prof_phase_t ph) {
+    if ((unsigned)ph >= PROF_PHASE_COUNT) return 0;
+    return s_cur_us[ph];
+}
+
+uint32_t prof_cycles(void) {
+    return s_prof.cycles;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Perfil do tempo acordado por fase do ciclo de wake. Cada fase soma os
+// trechos begin/end do wake (esp_timer_get_time() + contador de ciclos da CPU);
+// no fim do wake prof_commit() grava o ciclo na RTC e acumula min/média/máx
+// por fase até o próximo uplink, que leva um resumo compacto (payload.h).
+
+typedef enum {
+    PROF_BOOT = 0,     // acordar -> app_main (bootloader + startup)
+    PROF_ADC_INIT,     // adc_init + calibração
+    PROF_PROBE,        // burst do ADC + redução
+    PROF_TEMP,         // espera do DS18B20 (conversão menos init do ADC + burst)
+    PROF_PROCESS,      // TDS/salinidade + send-on-delta (inclui lote do ULP)
+    PROF_RADIO_INIT,   // lora_init + PHY
+    PROF_TX,           // envio dos lotes (bursts)
+    PROF_SLEEP,        // preparo do deep sleep (ULP, timer)
+    PROF_PHASE_COUNT
+} prof_phase_t;
+
+typedef struct {
+    uint32_t n;        // ciclos em que a fase rodou
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+} prof_stat_t;
+
+// Valida o estado em RTC (zera no boot frio) e limpa o ciclo atual
+void prof_init(bool cold_boot);
+
+void prof_begin(prof_phase_t ph);
+void prof_end(prof_phase_t ph);
+
+// Soma à fase um tempo medido por fora (ex.: boot, pelo relógio RTC)
+void prof_add_us(prof_phase_t ph, uint32_t us);
+
+// Fecha o ciclo: loga as fases e acumula nas estatísticas em RTC
+void prof_commit(void);
+
+// Estatística acumulada de uma fase (NULL se fora do intervalo)
+const prof_stat_t *prof_stat(prof_phase_t ph);
+
+// Tempo da fase no wake atual (até o último prof_end)
+uint32_t prof_current_us(prof_phase_t ph);
+
+// Wakes acumulados nas estatísticas (desde o último prof_reset_stats)
+uint32_t prof_cycles(void);
+
+// Zera as estatísticas (depois do resumo ser transmitido)
+void prof_reset_stats(void);
@@ -0,0 +1,57 @@
+#include <string.h>
+
+#include "esp_attr.h"
+
+#include "reading_log.h"
+
+#define READING_LOG_MAGIC  0x52444C47u // "RDLG"
+
+typedef struct {
+    uint32_t magic;
+    uint16_t head;   // posição da mais antiga
+    uint16_t count;
+    reading_t items[READING_LOG_CAPACITY];
+} reading_log_t;
+
+static RTC_DATA_ATTR reading_log_t s_log;
+
+void reading_log_init(bool cold_boot) {
+    if (cold_boot || s_log.magic != READING_LOG_MAGIC
+        || s_log.head >= READING_LOG_CAPACITY || s_log.count > READING_LOG_CAPACITY) {
+        memset(&s_log, 0, sizeof(s_log));
+        s_log.magic = READING_LOG_MAGIC;
+    }
+}
+
+bool reading_log_push(const reading_t *r) {
+    bool kept_all = true;
+    if (s_log.count == READING_LOG_CAPACITY) {
+        s_log.head = (s_log.head + 1) % READING_LOG_CAPACITY;
+        s_log.count--;
+        kept_all = false;
+    }
+    s_log.items[(s_log.head + s_log.count) % READING_LOG_CAPACITY] = *r;
+    s_log.count++;
+    return kept_all;
+}
+
+int reading_log_count(void) {
+    return s_log.count;
+}
+
+const reading_t *reading_log_peek(int i) {
+    if (i < 0 || i >= s_log.count) return NULL;
+    return &s_log.items[(s_log.head + i) % READING_LOG_CAPACITY];
+}
+
+void reading_log_drop(int n) {
+    if (n > s_log.count) n = s_log.count;
+    s_log.head = (s_log.head + n) % READING_LOG_CAPACITY;
+    s_log.count -= n;
+}
+
+uint32_t reading_log_oldest_age_s(uint32_t now_s) {
+    if (s_log.count == 0) return 0;
+    uint32_t t = s_log.items[s_log.head].t_s;
+    return now_s > t ? now_s - t : 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fila circular de leituras na RTC slow memory: sobrevive ao deep sleep e
+// permite ligar o rádio só a cada N wakes, mandando o lote inteiro de uma vez.
+
+#define READING_LOG_CAPACITY   32
+#define READING_NO_TEMP        INT16_MIN // temp_cc quando o DS18B20 falhou
+
+typedef struct {
+    uint32_t t_s;        // instante da leitura (s desde o boot frio, relógio RTC)
+    uint16_t tds_ppm;
+    uint16_t mv;         // tensão da sonda
+    int16_t  temp_cc;    // centésimos de °C ou READING_NO_TEMP
+    uint16_t sal_milli;  // salinidade prática * 1000 (0 sem temperatura)
+} reading_t;
+
+// Valida a fila em RTC (zera se corrompida ou no boot frio)
+void reading_log_init(bool cold_boot);
+
+// Enfileira; se cheia, descarta a mais antiga e devolve false
+bool reading_log_push(const reading_t *r);
+
+int reading_log_count(void);
+
+// i = 0 é a mais antiga
+const reading_t *reading_log_peek(int i);
+
+// Remove as n mais antigas (depois de transmitidas)
+void reading_log_drop(int n);
+
+// Idade da leitura mais antiga em s (0 se vazia)
+uint32_t reading_log_oldest_age_s(uint32_t now_s);
@@ -0,0 +1,54 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "report_sched.h"
+
+#define REPORT_MAGIC       0x534F4431u // "SOD1"
+#define TREND_EWMA_DIV     4           // alfa = 1/4
+
+void report_sched_reset(report_state_t *st) {
+    memset(st, 0, sizeof(*st));
+}
+
+static uint32_t sleep_for_trend(const report_cfg_t *cfg, int32_t trend_h) {
+    uint32_t span = cfg->sleep_max_s - cfg->sleep_min_s;
+    uint32_t rate = (uint32_t)abs(trend_h);
+    if (cfg->fast_rate_h <= 0 || rate >= (uint32_t)cfg->fast_rate_h) return cfg->sleep_min_s;
+    // linear: parado -> máximo, fast_rate_h -> mínimo
+    return cfg->sleep_max_s - (uint32_t)(((uint64_t)span * rate) / (uint32_t)cfg->fast_rate_h);
+}
+
+report_decision_t report_sched_step(report_state_t *st, const report_cfg_t *cfg,
+                                    int32_t value, uint32_t now_s) {
+    report_decision_t d = { .reason = REPORT_SKIP, .sleep_s = cfg->sleep_max_s };
+
+    if (st->magic != REPORT_MAGIC) {
+        report_sched_reset(st);
+        st->magic = REPORT_MAGIC;
+        st->prev_value = value;
+        st->prev_t_s = now_s;
+        d.reason = REPORT_FIRST;
+        d.sleep_s = cfg->sleep_min_s; // sem tendência ainda: amostra rápido
+    } else {
+        uint32_t dt = now_s - st->prev_t_s;
+        if (dt > 0) {
+            int32_t rate_h = (int32_t)(((int64_t)(value - st->prev_value) * 3600) / dt);
+            st->trend_h += (rate_h - st->trend_h) / TREND_EWMA_DIV;
+        }
+        st->prev_value = value;
+        st->prev_t_s = now_s;
+        d.sleep_s = sleep_for_trend(cfg, st->trend_h);
+
+        if (abs(value - st->last_reported) >= cfg->delta) {
+            d.reason = REPORT_DELTA;
+        } else if (now_s - st->last_reported_t_s >= cfg->heartbeat_s) {
+            d.reason = REPORT_HEARTBEAT;
+        }
+    }
+
+    if (d.reason != REPORT_SKIP) {
+        st->last_reported = value;
+        st->last_reported_t_s = now_s;
+    }
+    return d;
+}
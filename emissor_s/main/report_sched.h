@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Agendador send-on-delta: guarda o último valor reportado e uma tendência
+// (EWMA da taxa de variação) na RTC. Só reporta quando o valor andou mais que
+// o limiar ou o heartbeat venceu, e estica/encolhe o deep sleep conforme a
+// taxa de variação. Não depende de hardware (dá p/ reproduzir séries no host).
+
+typedef struct {
+    int32_t  delta;        // variação (mesma unidade do valor) que força reporte
+    uint32_t heartbeat_s;  // reporta pelo menos a cada heartbeat_s
+    uint32_t sleep_min_s;  // sono com variação rápida
+    uint32_t sleep_max_s;  // sono com valor parado
+    int32_t  fast_rate_h;  // |taxa| (unid./hora) em que o sono chega ao mínimo
+} report_cfg_t;
+
+typedef struct {
+    uint32_t magic;
+    int32_t  last_reported;
+    uint32_t last_reported_t_s;
+    int32_t  prev_value;     // leitura anterior (reportada ou não), p/ a tendência
+    uint32_t prev_t_s;
+    int32_t  trend_h;        // EWMA da taxa em unid./hora
+} report_state_t;
+
+typedef enum {
+    REPORT_SKIP = 0,
+    REPORT_FIRST,      // sem histórico (boot frio)
+    REPORT_DELTA,      // passou do limiar
+    REPORT_HEARTBEAT,  // sem variação, mas venceu o heartbeat
+} report_reason_t;
+
+typedef struct {
+    report_reason_t reason;   // REPORT_SKIP = não reportar esta leitura
+    uint32_t sleep_s;         // próximo intervalo de deep sleep
+} report_decision_t;
+
+// Zera o estado (boot frio)
+void report_sched_reset(report_state_t *st);
+
+// Processa uma leitura; se decidir reportar, já registra como último reportado
+report_decision_t report_sched_step(report_state_t *st, const report_cfg_t *cfg,
+                                    int32_t value, uint32_t now_s);
@@ -0,0 +1,71 @@
+#include <math.h>
+
+#include "salinity.h"
+
+// rt(t) = C(35,t,0)/C(35,15,0): c0 + c1 t + ... + c4 t^4
+#define RT_C0   0.6766097f
+#define RT_C1   2.00564e-2f
+#define RT_C2   1.104259e-4f
+#define RT_C3  -6.9698e-7f
+#define RT_C4   1.0031e-9f
+
+// S = sum a_i x^i + f(t) * sum b_i x^i, com x = sqrt(Rt)
+#define PSS_A0  0.0080f
+#define PSS_A1 -0.1692f
+#define PSS_A2  25.3851f
+#define PSS_A3  14.0941f
+#define PSS_A4 -7.0261f
+#define PSS_A5  2.7081f
+
+#define PSS_B0  0.0005f
+#define PSS_B1 -0.0056f
+#define PSS_B2 -0.0066f
+#define PSS_B3 -0.0375f
+#define PSS_B4  0.0636f
+#define PSS_B5 -0.0144f
+
+#define PSS_K   0.0162f
+
+// Rp = 1 + p (e1 + e2 p + e3 p^2) / (1 + d1 t + d2 t^2 + (d3 + d4 t) R)
+#define RP_E1   2.070e-5f
+#define RP_E2  -6.370e-10f
+#define RP_E3   3.989e-15f
+#define RP_D1   3.426e-2f
+#define RP_D2   4.464e-4f
+#define RP_D3   4.215e-1f
+#define RP_D4  -3.107e-3f
+
+float salinity_pss78(float cond_ms_cm, float temp_c) {
+    return salinity_pss78_p(cond_ms_cm, temp_c, 0.0f);
+}
+
+float salinity_pss78_p(float cond_ms_cm, float temp_c, float p_dbar) {
+    if (cond_ms_cm <= 0.0f) return 0.0f;
+
+    float t = 1.00024f * temp_c; // ITS-90 -> IPTS-68, escala das constantes
+    float rt = (((RT_C4 * t + RT_C3) * t + RT_C2) * t + RT_C1) * t + RT_C0;
+    float R = cond_ms_cm / SAL_C35_MS_CM;
+    float Rp = 1.0f;
+    if (p_dbar != 0.0f) {
+        Rp += p_dbar * ((RP_E3 * p_dbar + RP_E2) * p_dbar + RP_E1)
+            / ((RP_D2 * t + RP_D1) * t + 1.0f + (RP_D4 * t + RP_D3) * R);
+    }
+    float Rt = R / (Rp * rt);
+    if (Rt <= 0.0f) return 0.0f;
+
+    float x = sqrtf(Rt);
+    float ft = (t - 15.0f) / (1.0f + PSS_K * (t - 15.0f));
+    float sa = ((((PSS_A5 * x + PSS_A4) * x + PSS_A3) * x + PSS_A2) * x + PSS_A1) * x + PSS_A0;
+    float sb = ((((PSS_B5 * x + PSS_B4) * x + PSS_B3) * x + PSS_B2) * x + PSS_B1) * x + PSS_B0;
+    float s = sa + ft * sb;
+
+    if (s < 2.0f) {
+        // extensão p/ baixa salinidade (Hill, Dauphinee & Woods, 1986)
+        float hx = 400.0f * Rt;
+        float hy = 100.0f * Rt;
+        float sy = x * 10.0f; // sqrt(100 Rt)
+        s -= PSS_A0 / (1.0f + 1.5f * hx + hx * hx)
+           + PSS_B0 * ft / (1.0f + sy + hy + hy * sy);
+    }
+    return s > 0.0f ? s : 0.0f;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+// Salinidade prática PSS-78 (UNESCO 1983) a partir de condutividade e
+// temperatura; o firmware usa a pressão de superfície (p = 0, sonda rasa).
+// Os polinômios em sqrt(Rt) e em t são avaliados por Horner.
+
+#define SAL_C35_MS_CM    42.914f  // C(35, 15 °C, 0) em mS/cm
+
+// Condutividade in situ (mS/cm) e temperatura IPTS-68/ITS-90 (°C) -> S_P.
+// Válido p/ 2 <= S_P <= 42; abaixo disso aplica a extensão de Hill et al. (1986).
+float salinity_pss78(float cond_ms_cm, float temp_c);
+
+// Idem com o termo de pressão Rp (p em dbar, relativa à superfície)
+float salinity_pss78_p(float cond_ms_cm, float temp_c, float p_dbar);
+
+// Salinidade absoluta TEOS-10 aproximada pela salinidade de referência
+// S_R = (35.16504/35) * S_P (g/kg), sem a anomalia regional delta S_A
+static inline float salinity_teos10_sr(float sp) {
+    return sp * (35.16504f / 35.0f);
+}
+
+// TDS (ppm, já compensado a 25 °C pelo kernel) -> condutividade in situ (mS/cm).
+// O polinômio E-201-C usa TDS = 0,5 * EC25; desfaz a compensação de 2 %/°C.
+static inline float salinity_cond_from_tds(float tds_ppm, float temp_c) {
+    float ec25_ms_cm = tds_ppm * 2.0f * 1e-3f;
+    return ec25_ms_cm * (1.0f + 0.02f * (temp_c - 25.0f));
+}
@@ -0,0 +1,88 @@
+#include "sample_reducer.h"
+
+// compare-troca sem desvio: vira MINU/MAXU no Xtensa
+static inline void cmpxchg(uint16_t *v, int i, int j) {
+    uint16_t a = v[i], b = v[j];
+    v[i] = a < b ? a : b;
+    v[j] = a < b ? b : a;
+}
+
+// Merge-exchange de Batcher (Knuth, Algoritmo 5.2.2M): serve p/ qualquer n
+void reducer_sort(uint16_t *v, int n) {
+    if (n < 2) return;
+    int t = 0;
+    while ((1 << t) < n) t++;
+    for (int p = 1 << (t - 1); p > 0; p >>= 1) {
+        int q = 1 << (t - 1), r = 0, d = p;
+        for (;;) {
+            for (int i = 0; i < n - d; i++) {
+                if ((i & p) == r) cmpxchg(v, i, i + d);
+            }
+            if (q == p) break;
+            d = q - p;
+            q >>= 1;
+            r = p;
+        }
+    }
+}
+
+// média Q4 de v[lo..hi) com arredondamento
+static uint32_t mean_q4(const uint16_t *v, int lo, int hi) {
+    uint32_t sum = 0;
+    for (int i = lo; i < hi; i++) sum += v[i];
+    uint32_t cnt = (uint32_t)(hi - lo);
+    return cnt ? ((sum << 4) + cnt / 2) / cnt : 0;
+}
+
+// Com o vetor ordenado, as amostras aceitas formam sempre um intervalo contínuo
+static uint32_t sigma_clip_q4(const uint16_t *v, int n) {
+    int lo = 0, hi = n;
+    for (int it = 0; it < REDUCER_CLIP_ITERS && hi - lo > 2; it++) {
+        int64_t sum = 0, sum2 = 0;
+        for (int i = lo; i < hi; i++) {
+            sum  += v[i];
+            sum2 += (int64_t)v[i] * v[i];
+        }
+        int64_t cnt = hi - lo;
+        // tudo escalado por cnt^2 p/ ficar em inteiro: (x*cnt - sum)^2 <= K^2 * (cnt*sum2 - sum^2)
+        int64_t var_n2 = cnt * sum2 - sum * sum;
+        int64_t lim = (int64_t)REDUCER_CLIP_K * REDUCER_CLIP_K * var_n2;
+        int nlo = lo, nhi = hi;
+        while (nlo < nhi) {
+            int64_t dev = (int64_t)v[nlo] * cnt - sum;
+            if (dev * dev <= lim) break;
+            nlo++;
+        }
+        while (nhi > nlo) {
+            int64_t dev = (int64_t)v[nhi - 1] * cnt - sum;
+            if (dev * dev <= lim) break;
+            nhi--;
+        }
+        if (nhi - nlo == hi - lo || nhi <= nlo) break; // convergiu (ou degenerou)
+        lo = nlo;
+        hi = nhi;
+    }
+    return mean_q4(v, lo, hi);
+}
+
+uint32_t reducer_apply(reducer_mode_t mode, uint16_t *v, int n) {
+    if (n <= 0) return 0;
+    if (n > REDUCER_MAX_SAMPLES) n = REDUCER_MAX_SAMPLES;
+    if (mode == REDUCER_MEAN) return mean_q4(v, 0, n);
+
+    reducer_sort(v, n);
+    switch (mode) {
+    case REDUCER_MEDIAN:
+        // par: média dos dois centrais (em Q4 não perde o meio-LSB)
+        return (n & 1) ? ((uint32_t)v[n / 2] << 4)
+                       : (((uint32_t)v[n / 2 - 1] + v[n / 2]) << 3);
+    case REDUCER_TRIMMED_MEAN: {
+        int k = n * REDUCER_TRIM_PCT / 200;
+        return mean_q4(v, k, n - k);
+    }
+    case REDUCER_SIGMA_CLIP:
+        return sigma_clip_q4(v, n);
+    default:
+        return mean_q4(v, 0, n);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+// Redução do burst de amostras brutas em um único valor robusto a outliers
+// (glitch do ADC, bolha na sonda). Ordena com rede de comparação de Batcher:
+// a sequência de compare-troca depende só de n, então o custo é fixo.
+
+#define REDUCER_MAX_SAMPLES   64
+#define REDUCER_TRIM_PCT      25  // média aparada: descarta 12,5 % em cada ponta
+#define REDUCER_CLIP_K        2   // sigma-clip: mantém |x - média| <= K*sigma
+#define REDUCER_CLIP_ITERS    2   // nº fixo de iterações do sigma-clip
+
+typedef enum {
+    REDUCER_MEAN = 0,      // média simples (comportamento antigo)
+    REDUCER_MEDIAN,
+    REDUCER_TRIMMED_MEAN,
+    REDUCER_SIGMA_CLIP,
+} reducer_mode_t;
+
+// Ordena v[0..n-1] in-place (rede de Batcher, n <= REDUCER_MAX_SAMPLES)
+void reducer_sort(uint16_t *v, int n);
+
+// Reduz v[0..n-1] (reordena o vetor) e devolve a média em Q4 (contagens * 16)
+uint32_t reducer_apply(reducer_mode_t mode, uint16_t *v, int n);
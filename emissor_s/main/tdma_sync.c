@@ -0,0 +1,80 @@
+#include <string.h>
+
+#include "tdma_sync.h"
+
+#define TDMA_MAGIC   0x54444D41
+
+void tdma_sync_reset(tdma_sync_t *t) {
+    memset(t, 0, sizeof(*t));
+    t->magic = TDMA_MAGIC;
+}
+
+// Intervalo local -> intervalo no relógio do receptor
+static int64_t to_remote(const tdma_sync_t *t, int64_t local_ms) {
+    return local_ms + local_ms * t->drift_ppm / 1000000;
+}
+
+static int64_t to_local(const tdma_sync_t *t, int64_t remote_ms) {
+    return remote_ms * 1000000 / (1000000 + t->drift_ppm);
+}
+
+static uint32_t mod_frame(const tdma_sync_t *t, int64_t v) {
+    int64_t r = v % (int64_t)t->frame_ms;
+    return (uint32_t)(r < 0 ? r + t->frame_ms : r);
+}
+
+uint32_t tdma_sync_phase(const tdma_sync_t *t, int64_t now_ms) {
+    if (t->frame_ms == 0) return 0;
+    return mod_frame(t, (int64_t)t->ref_phase_ms + to_remote(t, now_ms - t->ref_local_ms));
+}
+
+int32_t tdma_sync_observe(tdma_sync_t *t, int64_t now_ms, uint32_t phase_ms,
+                          uint16_t slot_ms, uint8_t nslots, int slot) {
+    uint32_t frame = (uint32_t)slot_ms * nslots;
+    if (t->magic != TDMA_MAGIC || frame != t->frame_ms) {
+        tdma_sync_reset(t); // primeira vez ou o receptor mudou o superquadro
+        t->frame_ms = frame;
+        t->slot_ms = slot_ms;
+        t->nslots = nslots;
+    }
+
+    int32_t err = 0;
+    if (t->syncs > 0) {
+        // erro da previsão, no intervalo [-frame/2, frame/2)
+        int64_t d = (int64_t)phase_ms - tdma_sync_phase(t, now_ms);
+        d = mod_frame(t, d + frame / 2) - (int64_t)(frame / 2);
+        err = (int32_t)d;
+        int64_t dt = now_ms - t->ref_local_ms;
+        if (dt >= TDMA_DRIFT_MIN_DT_MS) {
+            // 1ª estimativa inteira; depois metade do resíduo por sync,
+            // p/ filtrar o jitter de detecção do pacote
+            int64_t ppm = t->drift_ppm + d * 1000000 / dt / (t->syncs > 1 ? 2 : 1);
+            if (ppm > TDMA_DRIFT_MAX_PPM) ppm = TDMA_DRIFT_MAX_PPM;
+            if (ppm < -TDMA_DRIFT_MAX_PPM) ppm = -TDMA_DRIFT_MAX_PPM;
+            t->drift_ppm = (int32_t)ppm;
+        }
+    }
+    t->ref_local_ms = now_ms;
+    t->ref_phase_ms = phase_ms % frame;
+    if (slot >= 0) t->slot = (uint8_t)slot;
+    if (t->syncs < UINT16_MAX) t->syncs++;
+    return err;
+}
+
+bool tdma_sync_valid(const tdma_sync_t *t, int64_t now_ms, uint32_t max_age_ms) {
+    return t->magic == TDMA_MAGIC && t->syncs > 0 && t->slot > 0 && t->slot < t->nslots
+        && now_ms >= t->ref_local_ms && now_ms - t->ref_local_ms <= max_age_ms;
+}
+
+uint32_t tdma_sync_wait_ms(const tdma_sync_t *t, int64_t now_ms, uint32_t guard_ms) {
+    uint32_t start = (uint32_t)t->slot * t->slot_ms + guard_ms;
+    uint32_t remote = mod_frame(t, (int64_t)start - tdma_sync_phase(t, now_ms));
+    return (uint32_t)to_local(t, remote);
+}
+
+uint32_t tdma_sync_slot_left_ms(const tdma_sync_t *t, int64_t now_ms) {
+    uint32_t phase = tdma_sync_phase(t, now_ms);
+    uint32_t start = (uint32_t)t->slot * t->slot_ms;
+    if (phase < start || phase >= start + t->slot_ms) return 0;
+    return (uint32_t)to_local(t, start + t->slot_ms - phase);
+}
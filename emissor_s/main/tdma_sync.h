@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sincronismo com o superquadro TDMA do receptor. Cada beacon/ACK dá a fase
+// do superquadro; entre eles a fase é prevista pelo relógio local (RTC no
+// deep sleep) corrigido pelo drift estimado nas sincronizações anteriores.
+// Só a fase importa: o estado cabe em RTC e não depende do relógio absoluto
+// do receptor. C puro (o host reproduz sequências de sync).
+
+#define TDMA_DRIFT_MIN_DT_MS   60000  // intervalo mínimo entre syncs p/ estimar drift
+#define TDMA_DRIFT_MAX_PPM     50000  // RC de 150 kHz sem calibrar erra até ~5 %
+
+typedef struct {
+    uint32_t magic;
+    int64_t  ref_local_ms;  // relógio local na última sincronização
+    uint32_t ref_phase_ms;  // fase do receptor nesse instante
+    int32_t  drift_ppm;     // (relógio do receptor / local - 1) * 1e6
+    uint32_t frame_ms;      // slot_ms * nslots
+    uint16_t slot_ms;
+    uint8_t  nslots;
+    uint8_t  slot;          // slot deste nó (0 = ainda não atribuído)
+    uint16_t syncs;
+} tdma_sync_t;
+
+void tdma_sync_reset(tdma_sync_t *t);
+
+// Registra uma observação da fase do receptor no instante local now_ms.
+// slot < 0 mantém o slot atual (beacon). Devolve o erro da previsão (ms),
+// 0 na primeira sincronização
+int32_t tdma_sync_observe(tdma_sync_t *t, int64_t now_ms, uint32_t phase_ms,
+                          uint16_t slot_ms, uint8_t nslots, int slot);
+
+// true se há slot e a última sincronização tem menos de max_age_ms
+bool tdma_sync_valid(const tdma_sync_t *t, int64_t now_ms, uint32_t max_age_ms);
+
+// Fase prevista do receptor em now_ms
+uint32_t tdma_sync_phase(const tdma_sync_t *t, int64_t now_ms);
+
+// Tempo local (ms) até o início do próximo slot do nó + guard_ms
+uint32_t tdma_sync_wait_ms(const tdma_sync_t *t, int64_t now_ms, uint32_t guard_ms);
+
+// Tempo local (ms) que ainda resta do slot do nó em now_ms (0 fora dele)
+uint32_t tdma_sync_slot_left_ms(const tdma_sync_t *t, int64_t now_ms);
@@ -0,0 +1,43 @@
+#include "tds_kernel.h"
+
+// Coeficientes já multiplicados por 0.5, em Q16 (arredondados)
+#define TDS_A3_Q16   ((int64_t)4371907)   //  66.710  * 65536
+#define TDS_A2_Q16   ((int64_t)-8384020)  // -127.930 * 65536
+#define TDS_A1_Q16   ((int64_t)28094956)  //  428.695 * 65536
+
+uint32_t tds_raw_sum_to_uv(uint32_t raw_sum, uint32_t n) {
+    if (n == 0) return 0;
+    // uv = (sum/n) * VREF/4095, com arredondamento; 32 x 4095 x 3.3e6 cabe em 64 bits
+    uint64_t num = (uint64_t)raw_sum * TDS_VREF_UV;
+    uint64_t den = (uint64_t)n * TDS_ADC_MAX;
+    return (uint32_t)((num + den / 2) / den);
+}
+
+int32_t tds_ppm_q16_from_uv(uint32_t uv, int32_t temp_cc) {
+    // 1 + 0.02*(T-25) em 1/10000: 10000 + 2*(T_cc - 2500)
+    int32_t comp = 10000 + 2 * (temp_cc - 2500);
+    if (comp < 1000) comp = 1000; // protege contra temperatura absurda (< -20 °C)
+
+    // tensão compensada em volts Q16: uv * 10000/comp * 65536/1e6
+    int64_t v = ((int64_t)uv * 65536 * 10000 / comp + 500000) / 1000000;
+
+    // Horner: ((a3*v + a2)*v + a1)*v, tudo em Q16
+    int64_t acc = TDS_A3_Q16;
+    acc = ((acc * v) >> TDS_Q) + TDS_A2_Q16;
+    acc = ((acc * v) >> TDS_Q) + TDS_A1_Q16;
+    acc = (acc * v) >> TDS_Q;
+
+    if (acc < 0) acc = 0;
+    if (acc > INT32_MAX) acc = INT32_MAX;
+    return (int32_t)acc;
+}
+
+float tds_ppm_float_ref(float voltage, float temp_c) {
+    float comp_coeff   = 1.0f + 0.02f * (temp_c - 25.0f);
+    float comp_voltage = voltage / comp_coeff;
+    float tds = (133.42f*comp_voltage*comp_voltage*comp_voltage
+              - 255.86f*comp_voltage*comp_voltage
+              + 857.39f*comp_voltage) * 0.5f;
+    if (tds < 0) tds = 0;
+    return tds;
+}
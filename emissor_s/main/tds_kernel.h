@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+// Conversão ADC -> TDS em ponto fixo (sem FPU, custo constante).
+// Mesmo modelo do caminho float: polinômio E-201-C/Gravity escalado por 0.5
+// e compensação de temperatura de 2 %/°C em torno de 25 °C.
+
+#define TDS_VREF_UV      3300000  // tensão de referência do ADC em uV
+#define TDS_ADC_MAX      4095     // 12 bits
+#define TDS_Q            16       // ppm e volts em Q16
+
+// Soma de n leituras brutas -> tensão em uV (escala linear VREF/4095)
+uint32_t tds_raw_sum_to_uv(uint32_t raw_sum, uint32_t n);
+
+// Tensão (uV) + temperatura (centésimos de °C) -> TDS em ppm Q16
+int32_t tds_ppm_q16_from_uv(uint32_t uv, int32_t temp_cc);
+
+// Atalho: soma bruta do burst direto para ppm Q16
+static inline int32_t tds_ppm_q16_from_raw(uint32_t raw_sum, uint32_t n, int32_t temp_cc) {
+    return tds_ppm_q16_from_uv(tds_raw_sum_to_uv(raw_sum, n), temp_cc);
+}
+
+// Caminho float original, mantido como referência p/ medir erro do kernel
+float tds_ppm_float_ref(float voltage, float temp_c);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Sensor de temperatura da água p/ compensação do TDS. A conversão é
+// disparada no início do wake e lida depois do burst do ADC; só essa parte
+// (alguns ms) se sobrepõe, o resto da conversão é espera. Backend simulado p/ o host em
+// tests/host/temp_sensor_sim.h.
+typedef struct temp_sensor temp_sensor_t;
+
+struct temp_sensor {
+    // Dispara a conversão e retorna logo
+    esp_err_t (*start)(temp_sensor_t *ts);
+    // Espera o que faltar da conversão (até timeout_ms) e lê em centésimos de °C
+    esp_err_t (*read)(temp_sensor_t *ts, int32_t *out_cc, uint32_t timeout_ms);
+    void *ctx;
+};
+
+static inline esp_err_t temp_sensor_start(temp_sensor_t *ts) { return ts->start(ts); }
+static inline esp_err_t temp_sensor_read(temp_sensor_t *ts, int32_t *out_cc, uint32_t timeout_ms) {
+    return ts->read(ts, out_cc, timeout_ms);
+}
+
+// DS18B20 sozinho no barramento 1-wire (Skip ROM), bit-bang em open-drain.
+// resolution_bits 9..12: 9 bits converte em ~94 ms, 12 bits em ~750 ms.
+esp_err_t temp_sensor_ds18b20_init(temp_sensor_t *ts, int gpio, int resolution_bits);
+
+// Scratchpad do DS18B20 (1/16 °C) -> centésimos de °C. Em 9..11 bits os bits
+// baixos não usados são indefinidos (datasheet), então são mascarados
+static inline int32_t ds18b20_raw_to_cc(int16_t t16, int resolution_bits) {
+    t16 &= (int16_t)~((1 << (12 - resolution_bits)) - 1);
+    return ((int32_t)t16 * 100 + (t16 >= 0 ? 8 : -8)) / 16;
+}
@@ -0,0 +1,167 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+
+#include "temp_sensor.h"
+
+#define TAG "DS18B20"
+
+#define OW_SKIP_ROM          0xCC
+#define OW_CONVERT_T         0x44
+#define OW_READ_SCRATCHPAD   0xBE
+#define OW_WRITE_SCRATCHPAD  0x4E
+
+typedef struct {
+    int gpio;
+    int resolution_bits;
+    int64_t start_us;   // instante em que a conversão foi disparada
+    bool converting;
+} ds18b20_ctx_t;
+
+static ds18b20_ctx_t s_ds;
+static portMUX_TYPE s_ow_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Resolução já gravada no sensor (ele fica alimentado durante o deep sleep)
+static RTC_DATA_ATTR uint8_t s_configured_bits;
+
+// ---------- 1-wire (timings padrão da Maxim) ----------
+
+static bool ow_reset(int gpio) {
+    gpio_set_level(gpio, 0);
+    esp_rom_delay_us(480);
+    portENTER_CRITICAL(&s_ow_mux);
+    gpio_set_level(gpio, 1);
+    esp_rom_delay_us(70);
+    bool presence = gpio_get_level(gpio) == 0;
+    portEXIT_CRITICAL(&s_ow_mux);
+    esp_rom_delay_us(410);
+    return presence;
+}
+
+static void ow_write_bit(int gpio, int bit) {
+    portENTER_CRITICAL(&s_ow_mux);
+    gpio_set_level(gpio, 0);
+    esp_rom_delay_us(bit ? 6 : 60);
+    gpio_set_level(gpio, 1);
+    portEXIT_CRITICAL(&s_ow_mux);
+    esp_rom_delay_us(bit ? 64 : 10);
+}
+
+static int ow_read_bit(int gpio) {
+    portENTER_CRITICAL(&s_ow_mux);
+    gpio_set_level(gpio, 0);
+    esp_rom_delay_us(6);
+    gpio_set_level(gpio, 1);
+    esp_rom_delay_us(9);
+    int bit = gpio_get_level(gpio);
+    portEXIT_CRITICAL(&s_ow_mux);
+    esp_rom_delay_us(55);
+    return bit;
+}
+
+static void ow_write_byte(int gpio, uint8_t v) {
+    for (int i = 0; i < 8; i++) ow_write_bit(gpio, (v >> i) & 1);
+}
+
+static uint8_t ow_read_byte(int gpio) {
+    uint8_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint8_t)(ow_read_bit(gpio) << i);
+    return v;
+}
+
+// CRC-8 Dallas/Maxim (x^8 + x^5 + x^4 + 1)
+static uint8_t ow_crc8(const uint8_t *p, int len) {
+    uint8_t crc = 0;
+    while (len--) {
+        uint8_t b = *p++;
+        for (int i = 0; i < 8; i++) {
+            uint8_t mix = (crc ^ b) & 1;
+            crc >>= 1;
+            if (mix) crc ^= 0x8C;
+            b >>= 1;
+        }
+    }
+    return crc;
+}
+
+// ---------- DS18B20 ----------
+
+static uint32_t conv_time_ms(int bits) {
+    return 750U >> (12 - bits); // 94, 188, 375, 750 ms
+}
+
+static esp_err_t ds_start(temp_sensor_t *ts) {
+    ds18b20_ctx_t *c = ts->ctx;
+    c->converting = false;
+    if (!ow_reset(c->gpio)) return ESP_ERR_NOT_FOUND;
+
+    if (s_configured_bits != c->resolution_bits) {
+        ow_write_byte(c->gpio, OW_SKIP_ROM);
+        ow_write_byte(c->gpio, OW_WRITE_SCRATCHPAD);
+        ow_write_byte(c->gpio, 0x7F);                                     // TH (não usado)
+        ow_write_byte(c->gpio, 0x80);                                     // TL (não usado)
+        ow_write_byte(c->gpio, (uint8_t)(((c->resolution_bits - 9) << 5) | 0x1F));
+        s_configured_bits = (uint8_t)c->resolution_bits;
+        if (!ow_reset(c->gpio)) return ESP_ERR_NOT_FOUND;
+    }
+
+    ow_write_byte(c->gpio, OW_SKIP_ROM);
+    ow_write_byte(c->gpio, OW_CONVERT_T);
+    c->start_us = esp_timer_get_time();
+    c->converting = true;
+    return ESP_OK;
+}
+
+static esp_err_t ds_read(temp_sensor_t *ts, int32_t *out_cc, uint32_t timeout_ms) {
+    ds18b20_ctx_t *c = ts->ctx;
+    if (!c->converting) return ESP_ERR_INVALID_STATE;
+    c->converting = false;
+
+    // espera só o que faltar; o sensor responde 1 no read slot quando termina
+    int64_t deadline = c->start_us + (int64_t)timeout_ms * 1000;
+    int64_t ready_at = c->start_us + (int64_t)conv_time_ms(c->resolution_bits) * 1000;
+    int64_t now = esp_timer_get_time();
+    if (now < ready_at) {
+        ESP_LOGD(TAG, "aguardando conversão: %lld us", (long long)(ready_at - now));
+        vTaskDelay(pdMS_TO_TICKS((ready_at - now) / 1000) + 1);
+    }
+    while (!ow_read_bit(c->gpio)) {
+        if (esp_timer_get_time() > deadline) {
+            s_configured_bits = 0; // força reconfigurar no próximo wake
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(1);
+    }
+
+    if (!ow_reset(c->gpio)) return ESP_ERR_NOT_FOUND;
+    ow_write_byte(c->gpio, OW_SKIP_ROM);
+    ow_write_byte(c->gpio, OW_READ_SCRATCHPAD);
+    uint8_t sp[9];
+    for (int i = 0; i < 9; i++) sp[i] = ow_read_byte(c->gpio);
+    if (ow_crc8(sp, 8) != sp[8]) return ESP_ERR_INVALID_CRC;
+
+    *out_cc = ds18b20_raw_to_cc((int16_t)((sp[1] << 8) | sp[0]), c->resolution_bits);
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_ds18b20_init(temp_sensor_t *ts, int gpio, int resolution_bits) {
+    if (resolution_bits < 9 || resolution_bits > 12) return ESP_ERR_INVALID_ARG;
+    ds18b20_ctx_t *c = &s_ds;
+    c->gpio = gpio;
+    c->resolution_bits = resolution_bits;
+    c->converting = false;
+
+    gpio_reset_pin(gpio);
+    gpio_set_direction(gpio, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode(gpio, GPIO_PULLUP_ONLY); // ajuda, mas use pull-up externo de 4k7
+    gpio_set_level(gpio, 1);
+
+    ts->start = ds_start;
+    ts->read  = ds_read;
+    ts->ctx   = c;
+    return ESP_OK;
+}
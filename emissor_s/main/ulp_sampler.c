@@ -0,0 +1,69 @@
+#include "sdkconfig.h"
+
+#if CONFIG_ULP_COPROC_ENABLED
+
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "ulp.h"
+#include "ulp_adc.h"
+#include "ulp_main.h" // gerado pelo ulp_embed_binary
+
+#include "ulp_sampler.h"
+
+#define TAG "ULP"
+
+extern const uint8_t ulp_main_bin_start[] asm("_binary_ulp_main_bin_start");
+extern const uint8_t ulp_main_bin_end[]   asm("_binary_ulp_main_bin_end");
+
+esp_err_t ulp_sampler_init(int unit, int channel, int atten) {
+    // recarregar a cada sono é barato (~100 palavras) e zera as variáveis do ULP
+    esp_err_t err = ulp_load_binary(0, ulp_main_bin_start,
+                                    (ulp_main_bin_end - ulp_main_bin_start) / sizeof(uint32_t));
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "ulp_load_binary: %s", esp_err_to_name(err));
+        return err;
+    }
+    ulp_adc_cfg_t cfg = {
+        .adc_n    = unit,
+        .channel  = channel,
+        .width    = ADC_BITWIDTH_DEFAULT,
+        .atten    = atten,
+        .ulp_mode = ADC_ULP_MODE_FSM,
+    };
+    return ulp_adc_init(&cfg);
+}
+
+esp_err_t ulp_sampler_arm(uint32_t period_s, int batch, int center_raw, int delta_raw) {
+    if (batch < 1) batch = 1;
+    if (batch > ULP_MAX_SAMPLES) batch = ULP_MAX_SAMPLES;
+    int lo = center_raw - delta_raw, hi = center_raw + delta_raw;
+    ulp_sample_count = 0;
+    ulp_batch_size   = (uint32_t)batch;
+    ulp_low_thr      = (uint32_t)(lo < 0 ? 0 : lo);
+    ulp_high_thr     = (uint32_t)(hi > 4095 ? 4095 : hi);
+
+    esp_err_t err = ulp_set_wakeup_period(0, period_s * 1000000U);
+    if (err != ESP_OK) return err;
+    err = esp_sleep_enable_ulp_wakeup();
+    if (err != ESP_OK) return err;
+    return ulp_run(&ulp_entry - RTC_SLOW_MEM);
+}
+
+void ulp_sampler_stop(void) {
+    ulp_timer_stop();
+}
+
+int ulp_sampler_count(void) {
+    int n = (int)(ulp_sample_count & 0xFFFF);
+    return n > ULP_MAX_SAMPLES ? ULP_MAX_SAMPLES : n;
+}
+
+uint16_t ulp_sampler_get(int i) {
+    return (uint16_t)((&ulp_samples)[i] & 0xFFFF);
+}
+
+uint16_t ulp_sampler_last(void) {
+    return (uint16_t)(ulp_last_result & 0xFFFF);
+}
+
+#endif // CONFIG_ULP_COPROC_ENABLED
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Amostragem da sonda pelo ULP-FSM durante o deep sleep (ulp/tds_sampler.S).
+// As CPUs principais só acordam quando o lote enche ou a leitura sai da janela.
+
+#define ULP_MAX_SAMPLES   64 // igual a max_samples no .S
+
+// (Re)carrega o programa e configura o ADC1 p/ o ULP; chamar depois de
+// liberar o ADC usado pelas CPUs principais, logo antes do deep sleep
+esp_err_t ulp_sampler_init(int unit, int channel, int atten);
+
+// Arma o ULP antes do deep sleep: período entre amostras, tamanho do lote e
+// janela [center - delta, center + delta] em contagens brutas. A média i do
+// lote sai (i + 1) períodos depois do arm (a 1ª espera o timer)
+esp_err_t ulp_sampler_arm(uint32_t period_s, int batch, int center_raw, int delta_raw);
+
+// Para o timer do ULP (início do wake completo): o programa não dispara mais
+// conversões no ADC1 enquanto as CPUs usam o ADC; ulp_sampler_arm() religa
+void ulp_sampler_stop(void);
+
+// Nº de médias guardadas pelo ULP desde o último arm
+int ulp_sampler_count(void);
+
+// i-ésima média (0 = mais antiga), em contagens brutas 0..4095
+uint16_t ulp_sampler_get(int i);
+
+// Última média medida pelo ULP (referência p/ a próxima janela)
+uint16_t ulp_sampler_last(void);
@@ -0,0 +1,99 @@
+#include <string.h>
+
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "esp_sleep.h"
+#include "esp_wake_stub.h"
+#include "soc/rtc.h"
+#include "soc/rtc_cntl_reg.h"
+#include "soc/soc.h"
+#if CONFIG_ULP_COPROC_ENABLED
+#include "ulp_main.h" // variáveis do tds_sampler.S
+#endif
+
+#include "wake_stub.h"
+
+#define WAKE_STUB_MAGIC   0x5753544Bu // "WSTK"
+#define RTC_CAL_FRACT     19          // calibração do slow clock: us/tick em Q19
+
+// Tudo que o stub toca precisa estar na RTC (ele roda antes da flash/IRAM)
+typedef struct {
+    uint32_t magic;            // gravado no primeiro sono; libera o fast path
+    uint32_t stub_wakes;
+    uint64_t entry_ticks;      // entrada no stub neste wake
+    uint64_t stub_last_ticks;
+    uint64_t stub_max_ticks;
+    uint64_t full_last_ticks;
+} wake_stub_state_t;
+
+static RTC_DATA_ATTR wake_stub_state_t s_ws;
+
+// Contador do RTC em ticks do slow clock: mesma sequência de rtc_time_get(),
+// que não pode ser chamada do stub. Sempre inline p/ ficar na RTC fast memory
+static inline __attribute__((always_inline)) uint64_t rtc_ticks(void) {
+    SET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_UPDATE);
+    while (GET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_VALID) == 0) {
+    }
+    SET_PERI_REG_MASK(RTC_CNTL_INT_CLR_REG, RTC_CNTL_TIME_VALID_INT_CLR);
+    uint64_t t = READ_PERI_REG(RTC_CNTL_TIME0_REG);
+    t |= ((uint64_t)READ_PERI_REG(RTC_CNTL_TIME1_REG)) << 32;
+    return t;
+}
+
+// Só fora do stub: a multiplicação de 64 bits chama a libgcc (flash)
+static uint32_t ticks_to_us(uint64_t ticks) {
+    uint64_t cal = READ_PERI_REG(RTC_CNTL_STORE1_REG); // RTC_SLOW_CLK_CAL_REG
+    return (uint32_t)((ticks * cal) >> RTC_CAL_FRACT);
+}
+
+void RTC_IRAM_ATTR esp_wake_deep_sleep(void) {
+    esp_default_wake_deep_sleep();
+    uint64_t t0 = rtc_ticks();
+    s_ws.entry_ticks = t0;
+
+#if CONFIG_ULP_COPROC_ENABLED
+    // Lote do ULP cheio e última média ainda na janela: nada a reportar.
+    // Descarta o lote, religa o timer do ULP (o .S desliga ao acordar) e dorme.
+    // O timer de wake (heartbeat / idade do lote) segue armado em valor absoluto.
+    uint32_t last = ulp_last_result & 0xFFFF;
+    if (s_ws.magic == WAKE_STUB_MAGIC
+        && (esp_wake_stub_get_wakeup_cause() & RTC_ULP_TRIG_EN)
+        && (ulp_sample_count & 0xFFFF) >= (ulp_batch_size & 0xFFFF)
+        && last >= (ulp_low_thr & 0xFFFF) && last <= (ulp_high_thr & 0xFFFF)) {
+        ulp_sample_count = 0;
+        SET_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+
+        uint64_t dt = rtc_ticks() - t0;
+        s_ws.stub_wakes++;
+        s_ws.stub_last_ticks = dt;
+        if (dt > s_ws.stub_max_ticks) s_ws.stub_max_ticks = dt;
+        esp_wake_stub_sleep(&esp_wake_deep_sleep); // não retorna
+    }
+#endif
+    // segue o boot normal
+}
+
+void wake_stub_take_stats(bool cold_boot, wake_stub_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    if (cold_boot || s_ws.magic != WAKE_STUB_MAGIC) {
+        memset(&s_ws, 0, sizeof(s_ws));
+        return;
+    }
+    out->stub_wakes   = s_ws.stub_wakes;
+    out->stub_last_us = ticks_to_us(s_ws.stub_last_ticks);
+    out->stub_max_us  = ticks_to_us(s_ws.stub_max_ticks);
+    out->full_last_us = ticks_to_us(s_ws.full_last_ticks);
+    s_ws.stub_wakes = 0;
+    s_ws.stub_last_ticks = 0;
+    s_ws.stub_max_ticks = 0;
+}
+
+uint32_t wake_stub_awake_us(void) {
+    if (s_ws.magic != WAKE_STUB_MAGIC) return 0;
+    return ticks_to_us(rtc_ticks() - s_ws.entry_ticks);
+}
+
+void wake_stub_before_sleep(void) {
+    s_ws.full_last_ticks = s_ws.magic == WAKE_STUB_MAGIC ? rtc_ticks() - s_ws.entry_ticks : 0;
+    s_ws.magic = WAKE_STUB_MAGIC;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fast path do deep sleep: esp_wake_deep_sleep() roda da RTC fast memory
+// antes do bootloader. Nos wakes do ULP em que o lote só encheu (última média
+// ainda dentro da janela, ou seja, nada a reportar) o stub zera o lote, religa
+// o timer do ULP e volta a dormir sem boot completo. O boot normal só acontece
+// quando a leitura sai da janela ou o timer vence (heartbeat / lote pendente).
+// Sem CONFIG_ULP_COPROC_ENABLED o stub só marca o instante do wake.
+//
+// Os tempos são do relógio RTC, da entrada no stub até o pedido de sono
+// (não incluem o power-up do domínio RTC nem a ROM, iguais nos dois caminhos).
+
+typedef struct {
+    uint32_t stub_wakes;     // wakes resolvidos só no stub desde o último boot
+    uint32_t stub_last_us;   // último wake no stub: acordar -> dormir
+    uint32_t stub_max_us;
+    uint32_t full_last_us;   // último wake completo (bootloader + app_main)
+} wake_stub_stats_t;
+
+// Lê as estatísticas do ciclo anterior e zera os contadores do stub
+// (chamar cedo no app_main; no boot frio devolve tudo zerado)
+void wake_stub_take_stats(bool cold_boot, wake_stub_stats_t *out);
+
+// us desde que o stub rodou neste wake (0 no boot frio)
+uint32_t wake_stub_awake_us(void);
+
+// Fecha a medição do wake completo; chamar logo antes do esp_deep_sleep_start()
+void wake_stub_before_sleep(void);
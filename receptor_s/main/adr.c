@@ -0,0 +1,56 @@
+#include <string.h>
+
+#include "adr.h"
+
+float adr_snr_floor_db(int sf) {
+    return -7.5f - 2.5f * (float)(sf - 7);
+}
+
+void adr_node_init(adr_node_t *n, int sf, int tx_dbm) {
+    memset(n, 0, sizeof(*n));
+    n->sf = (uint8_t)sf;
+    n->tx_dbm = (int8_t)tx_dbm;
+}
+
+void adr_observe(adr_node_t *n, float snr_db, int rssi_dbm) {
+    float q = snr_db * 4.0f;
+    if (q > 127.0f) q = 127.0f;
+    if (q < -128.0f) q = -128.0f;
+    n->snr_q[n->pos] = (int8_t)(q < 0 ? q - 0.5f : q + 0.5f);
+    n->pos = (uint8_t)((n->pos + 1) % ADR_HISTORY);
+    if (n->n < ADR_HISTORY) n->n++;
+    n->rssi = (int16_t)rssi_dbm;
+}
+
+float adr_margin_db(const adr_node_t *n) {
+    int best = -128;
+    for (int i = 0; i < n->n; i++) {
+        if (n->snr_q[i] > best) best = n->snr_q[i];
+    }
+    return (float)best / 4.0f - adr_snr_floor_db(n->sf) - (float)ADR_MARGIN_DB;
+}
+
+bool adr_update(adr_node_t *n, int sf_min, int sf_max) {
+    if (n->n < ADR_MIN_SAMPLES) return false;
+    float margin = adr_margin_db(n);
+    int steps = (int)(margin >= 0 ? margin / ADR_STEP_DB : (margin - (ADR_STEP_DB - 1)) / ADR_STEP_DB);
+    int sf = n->sf > sf_max ? sf_max : n->sf < sf_min ? sf_min : n->sf;
+    int dbm = n->tx_dbm;
+
+    // sobra margem: primeiro SF menor (menos tempo no ar), depois menos potência
+    for (; steps > 0 && sf > sf_min; steps--) sf--;
+    for (; steps > 0 && dbm - ADR_POWER_STEP_DB >= ADR_DBM_MIN; steps--) dbm -= ADR_POWER_STEP_DB;
+    // falta margem: volta a potência e, no máximo dela, sobe o SF
+    for (; steps < 0 && dbm < ADR_DBM_MAX; steps++) {
+        dbm += ADR_POWER_STEP_DB;
+        if (dbm > ADR_DBM_MAX) dbm = ADR_DBM_MAX;
+    }
+    for (; steps < 0 && sf < sf_max; steps++) sf++;
+
+    if (sf == n->sf && dbm == n->tx_dbm) return false;
+    n->sf = (uint8_t)sf;
+    n->tx_dbm = (int8_t)dbm;
+    n->n = 0;
+    n->pos = 0;
+    return true;
+}
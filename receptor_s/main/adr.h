@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ADR (adaptive data rate) no estilo do LoRaWAN: guarda o SNR dos últimos
+// pacotes de cada nó e recomenda o SF mais rápido (e depois a menor potência)
+// que ainda deixa ADR_MARGIN_DB acima do piso de demodulação do SF.
+// C puro; o estado de cada nó fica no registro (node_reg.h).
+
+#define ADR_HISTORY          8   // pacotes por nó (recomenda pelo melhor SNR)
+#define ADR_MIN_SAMPLES      4   // só recomenda com pelo menos isso no histórico
+#define ADR_MARGIN_DB        10  // folga de instalação (LoRaWAN usa 10 dB)
+#define ADR_STEP_DB          3   // cada passo = 1 SF ou ADR_POWER_STEP_DB de potência
+#define ADR_POWER_STEP_DB    3
+#define ADR_SF_MIN           7
+#define ADR_SF_MAX           12
+#define ADR_DBM_MIN          2   // faixa do PA_BOOST do SX127x
+#define ADR_DBM_MAX          17
+
+typedef struct {
+    int8_t   snr_q[ADR_HISTORY]; // SNR em 0,25 dB
+    uint8_t  n;          // amostras válidas em snr_q
+    uint8_t  pos;        // próxima posição (anel)
+    int16_t  rssi;       // último RSSI (dBm), só p/ log
+    uint8_t  sf;         // SF recomendado (o nó usa isso após o ACK)
+    int8_t   tx_dbm;     // potência recomendada
+} adr_node_t;
+
+// Começa o nó no SF/potência dados, sem histórico
+void adr_node_init(adr_node_t *n, int sf, int tx_dbm);
+
+// Registra o SNR/RSSI de um pacote recebido do nó
+void adr_observe(adr_node_t *n, float snr_db, int rssi_dbm);
+
+// Recalcula a recomendação do nó, com SF limitado a [sf_min, sf_max]
+// (sf_min == sf_max: só a potência se adapta). true se mudou; o histórico
+// é zerado, já que o SNR muda com o novo SF/potência
+bool adr_update(adr_node_t *n, int sf_min, int sf_max);
+
+// Margem (dB) do melhor SNR do histórico acima do piso do SF + ADR_MARGIN_DB
+float adr_margin_db(const adr_node_t *n);
+
+// Piso de SNR p/ demodular (datasheet SX1276): -7,5 dB no SF7 ... -20 dB no SF12
+float adr_snr_floor_db(int sf);
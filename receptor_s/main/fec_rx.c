@@ -0,0 +1,69 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "fec.h"
+#include "fec_rx.h"
+
+typedef struct {
+    bool     used;
+    bool     done;       // quadro já entregue: shards atrasados são ignorados
+    uint32_t node_id;
+    uint16_t seq;
+    uint8_t  k, m;
+    uint16_t frame_len;
+    uint16_t shard_len;
+    uint8_t  have;
+    bool     present[FEC_MAX_SHARDS];
+    uint32_t last_ms;
+    uint8_t  data[FEC_RX_SLOT_BYTES];
+} fec_slot_t;
+
+static fec_slot_t s_slots[FEC_RX_SLOTS];
+
+// Slot do (nó, seq); se não houver, o livre ou o usado há mais tempo
+static fec_slot_t *slot_for(const payload_fec_hdr_t *h, uint32_t now_ms) {
+    fec_slot_t *victim = &s_slots[0];
+    for (int i = 0; i < FEC_RX_SLOTS; i++) {
+        fec_slot_t *s = &s_slots[i];
+        if (s->used && s->node_id == h->node_id && s->seq == h->seq) return s;
+        if (!victim->used) continue;
+        if (!s->used || (now_ms - s->last_ms) > (now_ms - victim->last_ms)) victim = s;
+    }
+    memset(victim, 0, offsetof(fec_slot_t, data));
+    victim->used = true;
+    victim->node_id = h->node_id;
+    victim->seq = h->seq;
+    victim->k = h->k;
+    victim->m = h->m;
+    victim->frame_len = h->frame_len;
+    victim->shard_len = (uint16_t)((h->frame_len + h->k - 1) / h->k);
+    return victim;
+}
+
+int fec_rx_push(const payload_fec_hdr_t *h, const uint8_t *shard, int shard_len,
+                uint8_t *out, int cap, uint32_t now_ms) {
+    int n = h->k + h->m;
+    if (n * shard_len > FEC_RX_SLOT_BYTES || h->frame_len > cap) return FEC_RX_INVALID;
+
+    fec_slot_t *s = slot_for(h, now_ms);
+    if (s->k != h->k || s->m != h->m || s->frame_len != h->frame_len || s->shard_len != shard_len) {
+        return FEC_RX_INVALID; // mesmo (nó, seq) com outra geometria: descarta o shard
+    }
+    s->last_ms = now_ms;
+    if (s->done) return FEC_RX_DONE;
+    if (s->present[h->idx]) return FEC_RX_PENDING;
+
+    memcpy(s->data + h->idx * shard_len, shard, shard_len);
+    s->present[h->idx] = true;
+    if (++s->have < s->k) return FEC_RX_PENDING;
+
+    uint8_t *shards[FEC_MAX_SHARDS];
+    for (int i = 0; i < n; i++) shards[i] = s->data + i * shard_len;
+    if (!fec_decode(shards, s->present, s->k, s->m, shard_len)) return FEC_RX_INVALID;
+
+    // os shards de dados ficam contíguos: o quadro é o começo do buffer
+    memcpy(out, s->data, s->frame_len);
+    s->done = true;
+    return s->frame_len;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "payload.h"
+
+// Remontagem dos quadros enviados com FEC: guarda os shards por (nó, seq)
+// em poucos slots estáticos e reconstrói o quadro assim que chegam k dos
+// k+m shards. Slots antigos são reaproveitados (LRU).
+
+#define FEC_RX_SLOTS        4
+#define FEC_RX_SLOT_BYTES   2048 // (k+m) * tamanho do shard
+
+#define FEC_RX_PENDING      0  // ainda faltam shards
+#define FEC_RX_INVALID     -1  // shard inconsistente ou grande demais
+#define FEC_RX_DONE        -2  // quadro já entregue (shard atrasado/repetido)
+
+// Entrega um shard recebido. Quando o quadro fecha, copia-o p/ out e devolve
+// o tamanho (> 0); senão um dos FEC_RX_*
+int fec_rx_push(const payload_fec_hdr_t *h, const uint8_t *shard, int shard_len,
+                uint8_t *out, int cap, uint32_t now_ms);
@@ -1,12 +1,17 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/queue.h"
 
 #include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
@@ -19,6 +24,11 @@
 #include <inttypes.h>
 
 #include "lora.h" // driver da SX127x (LoRa)
+#include "lora_dio.h" // RxDone (DIO0) por interrupção
+#include "payload.h" // quadro binário do uplink (comum ao emissor)
+#include "fec_rx.h"
+#include "adr.h"
+#include "node_reg.h"
 
 #define TAG "RX_TS"
 
@@ -30,7 +40,108 @@
 #define RESTART_EVERY_S   70     // reinicia o ESP periodicamente (hard watchdog simplificado)
 #define INACTIVITY_S      0      // se >0: reinicia se ficar sem RX por esse tempo (segundos)
 
+#define RX_MAX_READINGS   32     // máx. de leituras num quadro (igual à fila do emissor)
+#define LORA_MAX_FRAME    255    // quadro remontado do FEC (o emissor limita ao FIFO)
+#define RX_SEND_ACK       1      // confirma (nó, seq) logo ao receber; o emissor encerra o burst
+// Espera entre o RxDone e o TX do ACK: o emissor só liga o RX depois que o
+// lora_send_packet() vê o TxDone (polling com vTaskDelay(1), até 2 ticks de
+// 10 ms) e a CPU sai do light sleep; sem isso o preâmbulo do ACK se perde
+// (em SF7 inteiro). Deve ficar abaixo do ACK_TURNAROUND_MS do emissor
+#define RX_ACK_DELAY_MS   40
+
+// Publicação: o task_rx só deixa a leitura mais recente na caixa do task_pub,
+// que faz o HTTPS (até HTTP_TIMEOUT_MS) sem segurar o RX, o ACK e o beacon
+#define HTTP_TIMEOUT_MS   7000
+#define PUB_MIN_GAP_MS    15000  // ThingSpeak aceita 1 update a cada 15 s
+
+// RX por interrupção: o task_rx bloqueia até o RxDone no DIO0 (pacote com CRC
+// ruim também sobe o RxDone) e só acorda sem pacote p/ o beacon e o revert do ADR.
+// A ISR do lora_dio roda da flash: durante escrita em flash (NVS do Wi-Fi) o
+// disparo espera o cache voltar, e o nível do DIO0 segura o RxDone até lá
+#define RX_USE_DIO0       1      // 0 = polling do rádio a cada RX_POLL_MS
+#define LORA_DIO0_GPIO    26     // DIO0 do SX1276 na Heltec LoRa32 v2
+#define RX_IDLE_MAX_MS    1000   // maior espera sem pacote
+#define RX_POLL_MS        100    // polling se a ISR não puder ser instalada
+
+// PHY padrão (deve bater com o emissor) e ADR: o ACK leva SF/potência
+// recomendados pelo SNR do nó. O SX127x só demodula um SF por vez, então com
+// vários emissores (e o beacon TDMA) o SF fica fixo e só a potência adapta.
+// RX_ADR_FOLLOW 1 é só p/ um emissor: o receptor passa a ouvir no SF
+// recomendado e volta ao padrão se o nó sumir por RX_ADR_REVERT_S (se o ACK
+// da troca se perder, fica surdo até lá)
+#define RX_CR             1
+#define RX_BW             7
+#define RX_SF             9
+#define RX_TX_DBM         17     // potência padrão do emissor (PA_BOOST)
+#define RX_ADR            1
+#define RX_ADR_FOLLOW     0
+#define RX_ADR_REVERT_S   2400   // > heartbeat do emissor + idade máx. do lote
+#define RX_ADR_MAGIC      0x41445232
+#define RX_NODES_MAGIC    0x4E4F4432
+
+// TDMA: superquadro de RX_TDMA_SLOTS slots de RX_TDMA_SLOT_MS no relógio do
+// RTC (segue nos esp_restart()); beacon no início de cada um (slot 0) e a fase
+// em todo ACK. Cada nó ganha um slot fixo (1..N-1), liberado se sumir. O
+// superquadro do último beacon fica no RTC: um restart não repete o beacon
+// nem o manda fora do slot 0 (em cima do slot de um nó)
+#define RX_TDMA           1
+#define RX_TDMA_SLOT_MS   3000
+#define RX_TDMA_SLOTS     20     // superquadro de 60 s, 19 slots de nó
+#define RX_TDMA_RECLAIM_S 3600   // slot de nó mudo há mais que isso volta a ficar livre
+#define RX_TDMA_MAGIC     0x54444D32
+
 static volatile uint32_t s_last_ok_rx_ms = 0; // marca do último RX válido (ms desde boot)
+static bool s_rx_irq; // lora_dio_init() ok: espera o DIO0 em vez de fazer polling
+
+// Registro dos nós (node_reg.h, com o ADR de cada um); RTC_NOINIT sobrevive
+// aos esp_restart() (periódico e após publicar)
+typedef struct {
+    uint32_t magic;
+    node_reg_t reg;
+} rx_nodes_state_t;
+
+static RTC_NOINIT_ATTR rx_nodes_state_t s_nodes;
+
+// Estado do ADR do receptor (também em RTC_NOINIT)
+typedef struct {
+    uint32_t magic;
+    uint8_t rx_sf;         // SF em que o receptor está ouvindo
+    uint32_t follow_node;  // nó cujo SF o receptor segue (0 = nenhum)
+    uint32_t last_rx_s;    // now_s() do último pacote do nó seguido
+} rx_adr_state_t;
+
+static RTC_NOINIT_ATTR rx_adr_state_t s_adr;
+
+// Dono de cada slot TDMA (também em RTC_NOINIT)
+typedef struct {
+    uint32_t magic;
+    uint32_t owner[RX_TDMA_SLOTS];   // node_id; 0 = livre (o slot 0 é do beacon)
+    uint32_t seen_s[RX_TDMA_SLOTS];  // now_s() do último ACK ao dono
+    uint64_t beacon_frame;           // superquadro do último beacon (ou pulado)
+} rx_tdma_state_t;
+
+static RTC_NOINIT_ATTR rx_tdma_state_t s_tdma;
+
+// SNR/RSSI do último pacote lido, ainda não contabilizado no ADR
+static float s_pkt_snr;
+static int s_pkt_rssi;
+static bool s_pkt_fresh;
+static int64_t s_pkt_rx_us; // esp_timer_get_time() na leitura do pacote
+
+// Uma leitura recebida (campos opcionais = NAN)
+typedef struct {
+    float ppm, v, t, sal;
+    uint32_t age_s; // há quanto tempo foi medida, no momento do envio
+} rx_reading_t;
+
+// Leitura à espera do task_pub e o nó de onde veio
+typedef struct {
+    uint32_t node_id;
+    rx_reading_t r;
+} rx_pub_t;
+
+static QueueHandle_t s_pub_q; // caixa de 1 leitura: a mais nova substitui
+static volatile uint32_t s_pub_failed; // tiradas da caixa mas sem Wi-Fi/HTTP ok
 
 static EventGroupHandle_t s_wifi_event_group;
 #define WIFI_CONNECTED_BIT BIT0
@@ -96,18 +207,26 @@ static void wifi_init_sta(void) {
 }
 
 // Envia dados ao ThingSpeak usando HTTP GET sobre HTTPS (TLS)
-static esp_err_t http_send_thingspeak(float tds, float voltage) {
+// temp_c/sal = NAN quando o emissor não mandou esses campos
+static esp_err_t http_send_thingspeak(float tds, float voltage, float temp_c, float sal) {
     char url[256];
-    // fields: field1=tds (ppm arredondado), field2=voltage
-    snprintf(url, sizeof(url),
+    // fields: field1=tds (ppm arredondado), field2=voltage, field3=temperatura (°C),
+    // field4=salinidade prática (PSS-78)
+    int n = snprintf(url, sizeof(url),
         "https://api.thingspeak.com/update?api_key=%s&field1=%.0f&field2=%.2f",
         THINGSPEAK_WRITE_KEY, tds, voltage);
+    if (!isnan(temp_c) && n > 0 && n < (int)sizeof(url)) {
+        n += snprintf(url + n, sizeof(url) - n, "&field3=%.2f", temp_c);
+    }
+    if (!isnan(sal) && n > 0 && n < (int)sizeof(url)) {
+        snprintf(url + n, sizeof(url) - n, "&field4=%.3f", sal);
+    }
 
     // GET síncrono
     esp_http_client_config_t cfg = {
         .url = url,
         .crt_bundle_attach = esp_crt_bundle_attach, // usa bundle interno de CAs
-        .timeout_ms = 7000,
+        .timeout_ms = HTTP_TIMEOUT_MS,
     };
     esp_http_client_handle_t h = esp_http_client_init(&cfg);
     if (!h) return ESP_FAIL;
@@ -122,17 +241,316 @@ static esp_err_t http_send_thingspeak(float tds, float voltage) {
     return err;
 }
 
-// Faz o parse do payload ASCII esperado: "TD,<ppm>,<volt>"
-static bool parse_payload(const char *s, float *out_tds, float *out_v) {
-    if (strncmp(s, "TD,", 3) != 0) return false; // prefixo obrigatório
-    const char *p = s + 3;
-    char *end = NULL;
-    float ppm = strtof(p, &end); // lê <ppm>
-    if (!end || *end != ',') return false; // exige vírgula
-    float volt = strtof(end + 1, NULL); // lê <volt>
-    if (out_tds) *out_tds = ppm;
-    if (out_v)   *out_v   = volt;
-    return true;
+// Decodifica um quadro binário (payload.h) em out; campos ausentes -> NAN.
+// Devolve o nº de leituras (0 = payload ignorado)
+static int decode_payload(const payload_frame_t *f, rx_reading_t *out, int max) {
+    payload_iter_t it;
+    payload_reading_t r;
+    int n = 0;
+    payload_iter_init(&it, f);
+    for (; n < max && payload_iter_next(&it, &r); n++) {
+        out[n].ppm   = r.tds_ppm;
+        out[n].v     = r.mv / 1000.0f;
+        out[n].t     = r.temp_cc != PAYLOAD_NO_TEMP ? r.temp_cc / 100.0f : NAN;
+        out[n].sal   = r.temp_cc != PAYLOAD_NO_TEMP ? r.sal_milli / 1000.0f : NAN;
+        out[n].age_s = r.age_s;
+    }
+    return n;
+}
+
+// Perfil por fase do emissor: ciclos e méd/máx em 0,1 ms
+// (boot,adc_init,probe,temp,process,radio_init,tx,sleep)
+static void log_profile(const payload_profile_t *p) {
+    char line[160];
+    int len = 0;
+    for (int i = 0; i < p->n && len < (int)sizeof(line); i++) {
+        len += snprintf(line + len, sizeof(line) - len, "%s%u/%u", i ? "," : "", p->avg[i], p->max[i]);
+    }
+    ESP_LOGI(TAG, "Perfil do emissor (%u ciclos): %s", p->cycles, p->n ? line : "-");
+}
+
+// Relógio do RTC: segue contando nos esp_restart()
+static uint32_t now_s(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)tv.tv_sec;
+}
+
+#if RX_TDMA
+// ms do relógio do RTC (base do superquadro TDMA)
+static uint64_t now_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000 + (uint64_t)tv.tv_usec / 1000;
+}
+
+// Fase atual do superquadro; chamar logo antes de lora_send_packet()
+static void tdma_now(payload_tdma_t *t) {
+    t->slot_ms = RX_TDMA_SLOT_MS;
+    t->nslots = RX_TDMA_SLOTS;
+    t->phase_ms = (uint32_t)(now_ms() % ((uint64_t)RX_TDMA_SLOT_MS * RX_TDMA_SLOTS));
+}
+
+// Slot do nó: o que já é dele, senão o primeiro livre (ou de dono sumido);
+// com tudo ocupado divide um slot pelo hash do node_id
+static uint8_t tdma_slot_for(uint32_t node_id) {
+    uint32_t now = now_s();
+    int slot = 0;
+    for (int i = 1; i < RX_TDMA_SLOTS && !slot; i++) {
+        if (s_tdma.owner[i] == node_id) slot = i;
+    }
+    for (int i = 1; i < RX_TDMA_SLOTS && !slot; i++) {
+        if (s_tdma.owner[i] == 0 || now - s_tdma.seen_s[i] > RX_TDMA_RECLAIM_S) {
+            if (s_tdma.owner[i]) ESP_LOGW(TAG, "TDMA: slot %d do nó %08" PRIx32 " liberado", i, s_tdma.owner[i]);
+            slot = i;
+            ESP_LOGI(TAG, "TDMA: slot %d -> nó %08" PRIx32, i, node_id);
+        }
+    }
+    if (!slot) return (uint8_t)(1 + node_id % (RX_TDMA_SLOTS - 1));
+    s_tdma.owner[slot] = node_id;
+    s_tdma.seen_s[slot] = now;
+    return (uint8_t)slot;
+}
+#endif
+
+// Quanto o task_rx pode dormir sem pacote: até o próximo beacon ou
+// RX_IDLE_MAX_MS (o revert do ADR é em segundos)
+static uint32_t rx_idle_ms(void) {
+#if RX_TDMA
+    uint32_t frame_ms = RX_TDMA_SLOT_MS * RX_TDMA_SLOTS;
+    uint32_t left = frame_ms - (uint32_t)(now_ms() % frame_ms);
+    return left < RX_IDLE_MAX_MS ? left : RX_IDLE_MAX_MS;
+#else
+    return RX_IDLE_MAX_MS;
+#endif
+}
+
+// Beacon no início de cada superquadro (a espera do task_rx acaba nele).
+// Fora do slot 0 (boot no meio do superquadro, ou o task_rx preso num
+// pacote) o beacon desse superquadro é pulado
+static void tdma_beacon_tick(void) {
+#if RX_TDMA
+    uint64_t frame = now_ms() / ((uint64_t)RX_TDMA_SLOT_MS * RX_TDMA_SLOTS);
+    if (frame == s_tdma.beacon_frame) return;
+    s_tdma.beacon_frame = frame;
+    payload_tdma_t t;
+    tdma_now(&t);
+    if (t.phase_ms >= RX_TDMA_SLOT_MS) {
+        ESP_LOGD(TAG, "Beacon pulado (fase %" PRIu32 " ms)", t.phase_ms);
+        return;
+    }
+    uint8_t buf[PAYLOAD_BEACON_LEN];
+    int len = payload_beacon_write(buf, sizeof(buf), &t);
+    lora_send_packet(buf, len);
+    lora_receive();
+    ESP_LOGD(TAG, "Beacon (fase %" PRIu32 " ms)", t.phase_ms);
+#endif
+}
+
+#if RX_TDMA
+// Carrega os slots e o último beacon retidos no RTC (ou começa vazio no power-on)
+static void tdma_state_init(void) {
+    if (s_tdma.magic == RX_TDMA_MAGIC) return;
+    memset(&s_tdma, 0, sizeof(s_tdma));
+    s_tdma.magic = RX_TDMA_MAGIC;
+    s_tdma.beacon_frame = UINT64_MAX;
+}
+#endif
+
+// Carrega o registro de nós retido no RTC (ou começa vazio no power-on)
+static void nodes_init(void) {
+    if (s_nodes.magic == RX_NODES_MAGIC && s_nodes.reg.count <= NODE_REG_MAX_NODES) {
+        ESP_LOGI(TAG, "Registro retido: %" PRIu32 " nós (%" PRIu32 " descartados)",
+                 s_nodes.reg.count, s_nodes.reg.evicted);
+        return;
+    }
+    node_reg_reset(&s_nodes.reg);
+    s_nodes.magic = RX_NODES_MAGIC;
+}
+
+// Entrada do nó (criada no 1º pacote; o ADR começa no SF em que o receptor ouve)
+static node_entry_t *node_get(uint32_t node_id) {
+    node_entry_t *e = node_reg_get(&s_nodes.reg, node_id, now_s());
+    if (e->adr.sf == 0) adr_node_init(&e->adr, s_adr.rx_sf, RX_TX_DBM);
+    return e;
+}
+
+// Carrega o estado do ADR retido no RTC (ou começa do padrão no power-on)
+static void adr_state_init(void) {
+    if (s_adr.magic == RX_ADR_MAGIC && s_adr.rx_sf >= ADR_SF_MIN && s_adr.rx_sf <= ADR_SF_MAX
+        && (RX_ADR_FOLLOW || s_adr.rx_sf == RX_SF)) {
+        ESP_LOGI(TAG, "ADR retido: ouvindo em SF%u (nó seguido %08" PRIx32 ")", s_adr.rx_sf, s_adr.follow_node);
+        return;
+    }
+    memset(&s_adr, 0, sizeof(s_adr));
+    s_adr.magic = RX_ADR_MAGIC;
+    s_adr.rx_sf = RX_SF;
+}
+
+// Volta a ouvir no SF padrão se o nó seguido sumiu (perdeu o ACK que mudou o
+// SF ou desistiu do ADR por falta de ACKs)
+static void adr_check_revert(void) {
+#if RX_ADR && RX_ADR_FOLLOW
+    if (s_adr.rx_sf == RX_SF || now_s() - s_adr.last_rx_s < RX_ADR_REVERT_S) return;
+    ESP_LOGW(TAG, "ADR: nó %08" PRIx32 " mudo há %d s em SF%u; voltando ao SF%d",
+             s_adr.follow_node, RX_ADR_REVERT_S, s_adr.rx_sf, RX_SF);
+    node_entry_t *e = node_reg_find(&s_nodes.reg, s_adr.follow_node);
+    if (e) adr_node_init(&e->adr, RX_SF, RX_TX_DBM);
+    s_adr.follow_node = 0;
+    s_adr.rx_sf = RX_SF;
+    lora_set_spreading_factor(RX_SF);
+    lora_receive();
+#endif
+}
+
+// Contabiliza o pacote recém-lido no registro e o SNR/RSSI no histórico de
+// ADR do nó (uma vez por pacote)
+static void link_observe(uint32_t node_id) {
+    if (!s_pkt_fresh) return;
+    s_pkt_fresh = false;
+    node_entry_t *e = node_get(node_id);
+    node_reg_packet(e, s_pkt_snr, s_pkt_rssi, now_s());
+#if RX_ADR
+    adr_observe(&e->adr, s_pkt_snr, s_pkt_rssi);
+    if (node_id == s_adr.follow_node) s_adr.last_rx_s = now_s();
+#endif
+}
+
+// Confirma o quadro (nó, seq): o emissor está com a janela de RX aberta logo
+// após o TX, então vai antes de qualquer log/HTTP, RX_ACK_DELAY_MS depois do
+// RxDone. O ACK sai no SF atual; se o ADR mudou o SF do nó seguido, o
+// receptor troca logo depois
+static void send_ack(uint32_t node_id, uint16_t seq) {
+#if RX_SEND_ACK
+    uint8_t ack[PAYLOAD_ACK_TDMA_LEN];
+    payload_ack_t a = { .node_id = node_id, .seq = seq };
+#if RX_ADR
+    adr_node_t *n = &node_get(node_id)->adr;
+    bool follow = RX_ADR_FOLLOW && (s_adr.follow_node == 0 || s_adr.follow_node == node_id);
+    if (!follow) n->sf = s_adr.rx_sf; // outro nó manda no SF: este só ajusta a potência
+    if (adr_update(n, follow ? ADR_SF_MIN : s_adr.rx_sf, follow ? ADR_SF_MAX : s_adr.rx_sf)) {
+        ESP_LOGI(TAG, "ADR nó %08" PRIx32 ": SF%u %d dBm (último RSSI %d dBm)",
+                 node_id, n->sf, n->tx_dbm, n->rssi);
+    }
+    a.has_adr = true;
+    a.sf = n->sf;
+    a.tx_dbm = n->tx_dbm;
+#endif
+    int64_t wait_us = s_pkt_rx_us + RX_ACK_DELAY_MS * 1000LL - esp_timer_get_time();
+    if (wait_us > 0) vTaskDelay(pdMS_TO_TICKS((uint32_t)(wait_us + 999) / 1000) + 1); // +1: nunca menos
+#if RX_TDMA
+    a.has_tdma = true;
+    a.slot = tdma_slot_for(node_id);
+    tdma_now(&a.tdma); // depois da espera: fase no início do TX
+#endif
+    int len = payload_ack_write(ack, sizeof(ack), &a);
+    lora_send_packet(ack, len); // o task_rx re-arma o RX depois
+#if RX_ADR
+    if (follow && n->sf != s_adr.rx_sf) {
+        ESP_LOGI(TAG, "ADR: ouvindo em SF%u (era SF%u)", n->sf, s_adr.rx_sf);
+        lora_set_spreading_factor(n->sf);
+        s_adr.rx_sf = n->sf;
+        s_adr.follow_node = n->sf != RX_SF ? node_id : 0;
+        s_adr.last_rx_s = now_s();
+    }
+#endif
+#endif
+}
+
+// Decodifica um quadro de leituras, confirma, loga e publica a mais recente.
+// Repetições de um (nó, seq) já entregue só são confirmadas de novo (o ACK
+// anterior pode ter se perdido) e contam como redundância do enlace
+static void handle_frame(const uint8_t *buf, int len) {
+    payload_frame_t frame;
+    rx_reading_t rd[RX_MAX_READINGS];
+    int n = payload_parse(buf, len, &frame) ? decode_payload(&frame, rd, RX_MAX_READINGS) : 0;
+    if (n <= 0 || frame.hdr.node_id == 0) { // node_id 0 é reservado (entrada vazia do registro)
+        ESP_LOGW(TAG, "Ignorado payload (%d bytes, 1º byte 0x%02x)", len, buf[0]);
+        return;
+    }
+    link_observe(frame.hdr.node_id);
+    send_ack(frame.hdr.node_id, frame.hdr.seq);
+    node_entry_t *e = node_get(frame.hdr.node_id);
+    if (!node_reg_frame(e, frame.hdr.seq, n, (uint16_t)rd[n - 1].ppm)) {
+        ESP_LOGD(TAG, "Repetido: nó %08" PRIx32 " seq %u (%" PRIu32 " redundantes de %" PRIu32 " pacotes)",
+                 frame.hdr.node_id, frame.hdr.seq, e->dups, e->packets);
+        return;
+    }
+    ESP_LOGI(TAG, "Quadro do nó %08" PRIx32 " seq %u: %d leituras, %d bytes "
+             "(nó: %" PRIu32 " quadros, %" PRIu32 " perdidos, %" PRIu32 "/%" PRIu32 " pacotes redundantes, "
+             "%" PRIu32 " leituras não publicadas, %d dBm, SNR %.1f dB)",
+             frame.hdr.node_id, frame.hdr.seq, n, len,
+             e->frames, e->lost, e->dups, e->packets, e->unpublished, e->rssi, e->snr_q / 4.0f);
+    if (frame.hdr.flags & PAYLOAD_F_PROFILE) log_profile(&frame.profile);
+
+    for (int i = 0; i < n; i++) {
+        ESP_LOGI(TAG, "LoRa ok [%d/%d, -%" PRIu32 " s]: ppm=%.0f v=%.2f t=%.2f S=%.3f",
+                 i + 1, n, rd[i].age_s, rd[i].ppm, rd[i].v, rd[i].t, rd[i].sal);
+    }
+    s_last_ok_rx_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+    // publica só a mais recente do lote; se o task_pub ainda não pegou a
+    // anterior, ela é substituída (não bloqueia). As que ficam de fora contam
+    // em unpublished do nó de origem (separado de dups: são leituras únicas)
+    e->unpublished += (uint32_t)(n - 1);
+    rx_pub_t p = { .node_id = frame.hdr.node_id, .r = rd[n - 1] }, old;
+    if (xQueueReceive(s_pub_q, &old, 0) == pdTRUE) {
+        node_entry_t *o = node_reg_find(&s_nodes.reg, old.node_id);
+        if (o) o->unpublished++;
+        ESP_LOGD(TAG, "Leitura do nó %08" PRIx32 " substituída antes de publicar", old.node_id);
+    }
+    xQueueSend(s_pub_q, &p, 0);
+}
+
+// Task que publica no ThingSpeak a leitura deixada pelo task_rx
+static void task_pub(void *arg) {
+    rx_pub_t p;
+    for (;;) {
+        xQueueReceive(s_pub_q, &p, portMAX_DELAY);
+        EventBits_t bits = xEventGroupGetBits(s_wifi_event_group);
+        if (!(bits & WIFI_CONNECTED_BIT)) {
+            ESP_LOGW(TAG, "Sem Wi-Fi; não enviou (%" PRIu32 " falhas).", ++s_pub_failed);
+            continue;
+        }
+        if (http_send_thingspeak(p.r.ppm, p.r.v, p.r.t, p.r.sal) != ESP_OK) {
+            ESP_LOGW(TAG, "Leitura do nó %08" PRIx32 " não publicada (%" PRIu32 " falhas)",
+                     p.node_id, ++s_pub_failed);
+        } else {
+// opcional: reiniciar após publicar para "garantir" próximo ciclo (a
+// deduplicação por seq já impede publicar o mesmo quadro duas vezes)
+#if 0   // 1 para reiniciar após publicar
+            ESP_LOGW(TAG, "Publicado com sucesso. Reiniciando...");
+            esp_restart();
+#endif
+        }
+        // leituras que chegarem nesse meio-tempo esperam na caixa (só a última)
+        vTaskDelay(pdMS_TO_TICKS(PUB_MIN_GAP_MS));
+    }
+}
+
+// Shard de FEC: guarda e, quando juntar k de k+m, trata o quadro remontado
+static void handle_fec_shard(const uint8_t *buf, int len) {
+    payload_fec_hdr_t h;
+    const uint8_t *shard;
+    int shard_len;
+    if (!payload_fec_parse(buf, len, &h, &shard, &shard_len) || h.node_id == 0) {
+        ESP_LOGW(TAG, "Shard FEC inválido (%d bytes)", len);
+        return;
+    }
+    link_observe(h.node_id); // por shard; o quadro remontado não conta de novo
+    uint8_t frame[LORA_MAX_FRAME];
+    uint32_t now_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    int flen = fec_rx_push(&h, shard, shard_len, frame, sizeof(frame), now_ms);
+    ESP_LOGD(TAG, "Shard %u/%u do nó %08" PRIx32 " seq %u", h.idx + 1, h.k + h.m, h.node_id, h.seq);
+    if (flen > 0) {
+        ESP_LOGI(TAG, "Quadro remontado com FEC (k=%u m=%u, shard %u)", h.k, h.m, h.idx + 1);
+        handle_frame(frame, flen);
+    } else if (flen == FEC_RX_DONE) {
+        node_get(h.node_id)->dups++;
+        send_ack(h.node_id, h.seq); // o ACK anterior se perdeu: o emissor seguiu mandando
+    } else if (flen == FEC_RX_INVALID) {
+        ESP_LOGW(TAG, "Shard FEC descartado (nó %08" PRIx32 " seq %u)", h.node_id, h.seq);
+    }
 }
 
 // Task principal de recepção LoRa e publicação
@@ -144,42 +562,43 @@ static void task_rx(void *arg) {
     lora_receive(); // coloca o rádio em RX contínuo
 
     while (1) {
-        if (lora_received()) { // checa IRQ/flag de pacote recebido
-            int rxLen = lora_receive_packet(buf, sizeof(buf)); // lê FIFO
-            if (rxLen > 0 && rxLen < (int)sizeof(buf)) {
-                buf[rxLen] = 0; // termina string
-                float ppm=0, v=0;
-                if (parse_payload((char*)buf, &ppm, &v)) {
-                    ESP_LOGI(TAG, "LoRa ok: ppm=%.0f v=%.2f", ppm, v);
-
-                    s_last_ok_rx_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
-
-                    // publica imediatamente no ThingSpeak (se Wi-Fi está conectado)
-                    EventBits_t bits = xEventGroupGetBits(s_wifi_event_group);
-                    if (bits & WIFI_CONNECTED_BIT) {
-                        if (http_send_thingspeak(ppm, v) == ESP_OK) {
-// opcional: reiniciar após publicar para "garantir" próximo ciclo
-#if 1   // 0 para desativar o reboot após publicar
-                            ESP_LOGW(TAG, "Publicado com sucesso. Reiniciando...");
-                            esp_restart();
-#endif
-                        }
-                    } else {
-                        ESP_LOGW(TAG, "Sem Wi-Fi; não enviou.");
-                    }
+        // bloqueia até o RxDone ou o próximo beacon; a interrupção é por
+        // nível, então um pacote que chegou antes do arm dispara na hora
+        bool woke = false;
+        if (s_rx_irq) {
+            lora_dio_arm();
+            woke = lora_dio_wait(pdMS_TO_TICKS(rx_idle_ms()) + 1);
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(RX_POLL_MS));
+        }
+
+        bool got = lora_received(); // checa IRQ/flag de pacote recebido
+        if (woke && !got) {
+            // DIO0 alto sem RxDone (TxDone pendente?): o nível redispararia
+            // a ISR em seguida, então espera como no polling
+            ESP_LOGD(TAG, "DIO0 sem pacote");
+            vTaskDelay(pdMS_TO_TICKS(RX_POLL_MS));
+        }
+        if (got) {
+            int rxLen = lora_receive_packet(buf, sizeof(buf)); // lê FIFO (0 com CRC ruim)
+            s_pkt_snr = lora_packet_snr();
+            s_pkt_rssi = lora_packet_rssi();
+            s_pkt_fresh = true;
+            s_pkt_rx_us = esp_timer_get_time();
+            if (rxLen > 0 && rxLen <= (int)sizeof(buf)) {
+                if (payload_type(buf, rxLen) == PAYLOAD_TYPE_FEC) {
+                    handle_fec_shard(buf, rxLen);
                 } else {
-                    ESP_LOGW(TAG, "Ignorado payload: %s", (char*)buf);
+                    handle_frame(buf, rxLen);
                 }
-
-                // Algumas libs saem de RX após ler FIFO; re-arma RX contínuo
-                lora_receive();
             } else {
-                // leitura inválida: re-arma RX assim mesmo
-                lora_receive();
+                ESP_LOGD(TAG, "Pacote com CRC inválido (%d no total)", lora_packet_lost());
             }
+            // Algumas libs saem de RX após ler FIFO; re-arma RX contínuo
+            lora_receive();
         }
-
-        vTaskDelay(pdMS_TO_TICKS(100)); // pequeno descanso para CPU/RTOS
+        adr_check_revert();
+        tdma_beacon_tick();
     }
 }
 
@@ -231,11 +650,25 @@ void app_main(void) {
 #endif
     lora_enable_crc(); // exige CRC nos pacotes
 
-    // parâmetros PHY (devem bater com o TX)
-    lora_set_coding_rate(1);
-    lora_set_bandwidth(7);
-    lora_set_spreading_factor(9);
+    // parâmetros PHY (devem bater com o TX); o SF pode ter vindo do ADR
+    adr_state_init();
+    nodes_init();
+#if RX_TDMA
+    tdma_state_init();
+#endif
+    lora_set_coding_rate(RX_CR);
+    lora_set_bandwidth(RX_BW);
+    lora_set_spreading_factor(s_adr.rx_sf);
     // lora_set_sync_word(0x12); // usar igual nos dois lados se ativar
 
-    xTaskCreate(task_rx, "RX", 4096, NULL, 5, NULL);
+#if RX_USE_DIO0
+    lora_set_dio_mapping(0, 0); // DIO0 = RxDone em RX (TxDone no ACK/beacon)
+    esp_err_t err = lora_dio_init(LORA_DIO0_GPIO);
+    s_rx_irq = err == ESP_OK;
+    if (!s_rx_irq) ESP_LOGW(TAG, "ISR do DIO0 indisponível (%s); RX por polling", esp_err_to_name(err));
+#endif
+
+    s_pub_q = xQueueCreate(1, sizeof(rx_pub_t));
+    xTaskCreate(task_pub, "PUB", 6144, NULL, 4, NULL); // folga p/ TLS
+    xTaskCreate(task_rx, "RX", 4096, NULL, 5, NULL);   // folga p/ lote decodificado
 }
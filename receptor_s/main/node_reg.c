@@ -0,0 +1,128 @@
+#include <string.h>
+
+#include "node_reg.h"
+
+#define MASK  (NODE_REG_CAP - 1)
+
+// Finalizador do murmur3: IDs sequenciais ou com os mesmos bytes altos
+// (MACs do mesmo OUI) se espalham pela tabela
+static uint32_t home(uint32_t node_id) {
+    uint32_t x = node_id;
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x & MASK;
+}
+
+// Posição do nó ou da vazia onde ele entraria
+static uint32_t probe(const node_reg_t *r, uint32_t node_id) {
+    uint32_t i = home(node_id);
+    while (r->e[i].node_id != 0 && r->e[i].node_id != node_id) i = (i + 1) & MASK;
+    return i;
+}
+
+// Esvazia a posição i puxando p/ trás as entradas seguintes da mesma
+// sequência que não ficariam antes da própria posição de origem
+static void delete_at(node_reg_t *r, uint32_t i) {
+    uint32_t j = i;
+    for (;;) {
+        r->e[i].node_id = 0;
+        uint32_t h;
+        do {
+            j = (j + 1) & MASK;
+            if (r->e[j].node_id == 0) return;
+            h = home(r->e[j].node_id);
+        } while (i <= j ? (i < h && h <= j) : (i < h || h <= j));
+        r->e[i] = r->e[j];
+        i = j;
+    }
+}
+
+void node_reg_reset(node_reg_t *r) {
+    memset(r, 0, sizeof(*r));
+}
+
+node_entry_t *node_reg_find(node_reg_t *r, uint32_t node_id) {
+    if (node_id == 0) return NULL;
+    node_entry_t *e = &r->e[probe(r, node_id)];
+    return e->node_id ? e : NULL;
+}
+
+node_entry_t *node_reg_get(node_reg_t *r, uint32_t node_id, uint32_t now_s) {
+    if (node_id == 0) return NULL;
+    uint32_t i = probe(r, node_id);
+    if (r->e[i].node_id) return &r->e[i];
+
+    if (r->count >= NODE_REG_MAX_NODES) {
+        uint32_t old = 0;
+        for (uint32_t k = 0, age = 0; k < NODE_REG_CAP; k++) {
+            if (r->e[k].node_id && now_s - r->e[k].last_s >= age) {
+                age = now_s - r->e[k].last_s;
+                old = k;
+            }
+        }
+        delete_at(r, old);
+        r->count--;
+        r->evicted++;
+        i = probe(r, node_id);
+    }
+    node_entry_t *e = &r->e[i];
+    memset(e, 0, sizeof(*e));
+    e->node_id = node_id;
+    e->first_s = now_s;
+    e->last_s = now_s;
+    r->count++;
+    return e;
+}
+
+bool node_reg_remove(node_reg_t *r, uint32_t node_id) {
+    if (node_id == 0) return false;
+    uint32_t i = probe(r, node_id);
+    if (!r->e[i].node_id) return false;
+    delete_at(r, i);
+    r->count--;
+    return true;
+}
+
+void node_reg_packet(node_entry_t *e, float snr_db, int rssi_dbm, uint32_t now_s) {
+    float q = snr_db * 4.0f;
+    if (q > 127.0f) q = 127.0f;
+    if (q < -128.0f) q = -128.0f;
+    e->snr_q = (int8_t)(q < 0 ? q - 0.5f : q + 0.5f);
+    e->rssi = (int16_t)rssi_dbm;
+    e->last_s = now_s;
+    e->packets++;
+}
+
+bool node_reg_frame(node_entry_t *e, uint16_t seq, int readings, uint16_t last_ppm) {
+    uint16_t ahead = (uint16_t)(seq - e->last_seq);
+    uint16_t behind = (uint16_t)(e->last_seq - seq);
+    bool latest = true;
+    if (e->frames == 0 || (ahead > NODE_REG_SEQ_JUMP && behind >= NODE_REG_SEQ_WINDOW)) {
+        if (e->frames) e->resyncs++;
+        e->seq_win = 1;
+        e->last_seq = seq;
+    } else if (ahead != 0 && ahead <= NODE_REG_SEQ_JUMP) {
+        e->lost += ahead - 1u;
+        e->seq_win = ahead < NODE_REG_SEQ_WINDOW ? e->seq_win << ahead | 1 : 1;
+        e->last_seq = seq;
+    } else {
+        uint32_t bit = 1u << behind; // behind < NODE_REG_SEQ_WINDOW aqui
+        if (e->seq_win & bit) {
+            e->dups++;
+            return false;
+        }
+        e->seq_win |= bit;
+        if (e->lost) e->lost--;
+        latest = false;
+    }
+
+    if (e->frames == 0 || last_ppm < e->min_ppm) e->min_ppm = last_ppm;
+    if (e->frames == 0 || last_ppm > e->max_ppm) e->max_ppm = last_ppm;
+    if (latest) e->last_ppm = last_ppm;
+    e->frames++;
+    e->readings += (uint32_t)readings;
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adr.h"
+
+// Registro dos emissores ouvidos: tabela estática de endereçamento aberto
+// (sondagem linear, capacidade potência de 2) indexada pelo node_id. Busca
+// O(1), sem heap; remoção por deslocamento, sem lápides. Com a tabela em
+// NODE_REG_MAX_NODES o nó visto há mais tempo dá lugar ao novo (varre a
+// tabela, só acontece na chegada de um nó novo). C puro; cabe em
+// RTC_NOINIT p/ sobreviver aos esp_restart().
+
+#ifndef NODE_REG_CAP
+#define NODE_REG_CAP        64
+#endif
+#define NODE_REG_MAX_NODES  (NODE_REG_CAP * 3 / 4) // carga máx.: sondas curtas
+
+// Deduplicação por (nó, seq): janela deslizante dos últimos NODE_REG_SEQ_WINDOW
+// seqs. Seq atrás da janela ou mais que NODE_REG_SEQ_JUMP à frente é tomado
+// como emissor reiniciado (começa num seq aleatório) e ressincroniza
+#define NODE_REG_SEQ_WINDOW 32
+#define NODE_REG_SEQ_JUMP   1024
+
+_Static_assert((NODE_REG_CAP & (NODE_REG_CAP - 1)) == 0, "NODE_REG_CAP precisa ser potência de 2");
+
+typedef struct {
+    uint32_t node_id;      // 0 = entrada vazia
+    uint32_t first_s;      // now_s() do primeiro pacote
+    uint32_t last_s;       // now_s() do último pacote
+    uint32_t packets;      // pacotes (cada shard de FEC conta)
+    uint32_t frames;       // quadros entregues
+    uint32_t readings;     // leituras nesses quadros
+    uint32_t lost;         // quadros pulados na sequência (sem ACK e sem FEC suficiente)
+    uint32_t dups;         // pacotes redundantes: quadro repetido ou shard após a remontagem
+    uint32_t unpublished;  // leituras únicas entregues mas não publicadas (só cabe
+                           // 1 update a cada 15 s: fica a mais nova)
+    uint32_t seq_win;      // bit i: seq last_seq - i já entregue
+    uint16_t last_seq;     // válido com frames > 0
+    uint16_t resyncs;      // saltos de seq (emissor reiniciado)
+    uint16_t last_ppm;     // leitura mais recente
+    uint16_t min_ppm, max_ppm;
+    int16_t  rssi;         // último pacote
+    int8_t   snr_q;        // último pacote, 0,25 dB
+    adr_node_t adr;        // recomendação de ADR (sf == 0: ainda não iniciada)
+} node_entry_t;
+
+typedef struct {
+    node_entry_t e[NODE_REG_CAP];
+    uint32_t count;
+    uint32_t evicted;      // nós descartados p/ caber outro
+} node_reg_t;
+
+void node_reg_reset(node_reg_t *r);
+
+// Entrada do nó ou NULL se não estiver registrado
+node_entry_t *node_reg_find(node_reg_t *r, uint32_t node_id);
+
+// Entrada do nó, criando (zerada) se preciso; NULL só p/ node_id 0. Inserir
+// ou remover move entradas: ponteiros antigos valem só até a próxima
+// node_reg_get/node_reg_remove de outro nó
+node_entry_t *node_reg_get(node_reg_t *r, uint32_t node_id, uint32_t now_s);
+
+bool node_reg_remove(node_reg_t *r, uint32_t node_id);
+
+// Registra um pacote recebido do nó
+void node_reg_packet(node_entry_t *e, float snr_db, int rssi_dbm, uint32_t now_s);
+
+// Registra um quadro recebido; false se o seq já foi entregue (conta em dups,
+// o chamador não repassa). Seq à frente conta os pulados como perdidos; um
+// atrasado dentro da janela é entregue e deixa de contar como perdido
+bool node_reg_frame(node_entry_t *e, uint16_t seq, int readings, uint16_t last_ppm);
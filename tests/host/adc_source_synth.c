@@ -0,0 +1,46 @@
+#include <stddef.h>
+
+#include "adc_source_synth.h"
+
+static uint32_t xorshift32(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+static esp_err_t synth_start(adc_source_t *src) {
+    return ESP_OK;
+}
+
+static int synth_read(adc_source_t *src, uint16_t *out, int n) {
+    adc_synth_ctx_t *c = src->ctx;
+    if (!c->pattern || c->len <= 0) return 0;
+    for (int i = 0; i < n; i++) {
+        int v = c->pattern[c->pos];
+        if (++c->pos >= c->len) c->pos = 0;
+        if (c->noise_amp) {
+            uint32_t span = 2U * c->noise_amp + 1U;
+            v += (int)(xorshift32(&c->seed) % span) - (int)c->noise_amp;
+        }
+        if (v < 0) v = 0;
+        if (v > 4095) v = 4095;
+        out[i] = (uint16_t)v;
+    }
+    return n;
+}
+
+void adc_source_synthetic_init(adc_source_t *src, adc_synth_ctx_t *ctx,
+                               const uint16_t *pattern, int len, uint16_t noise_amp) {
+    ctx->pattern   = pattern;
+    ctx->len       = len;
+    ctx->pos       = 0;
+    ctx->noise_amp = noise_amp;
+    if (!ctx->seed) ctx->seed = 0x2545F491u;
+
+    src->start = synth_start;
+    src->read  = synth_read;
+    src->stop  = NULL;
+    src->ctx   = ctx;
+}
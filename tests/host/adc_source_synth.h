@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "adc_source.h"
+
+// Fonte sintética do adc_source_t: repete 'pattern' (amostras gravadas ou
+// geradas) + ruído opcional, p/ rodar o pipeline do ADC no host.
+typedef struct {
+    const uint16_t *pattern;
+    int len;
+    int pos;
+    uint16_t noise_amp; // amplitude do ruído uniforme (+/- em contagens), 0 = sem ruído
+    uint32_t seed;      // estado do PRNG (xorshift32)
+} adc_synth_ctx_t;
+
+void adc_source_synthetic_init(adc_source_t *src, adc_synth_ctx_t *ctx,
+                               const uint16_t *pattern, int len, uint16_t noise_amp);
@@ -0,0 +1,14 @@
+#pragma once
+
+// Só o necessário do esp_err.h do ESP-IDF p/ as interfaces do firmware
+// (adc_source.h, temp_sensor.h) compilarem no host; mesmos valores do IDF
+
+typedef int esp_err_t;
+
+#define ESP_OK                  0
+#define ESP_FAIL               -1
+#define ESP_ERR_INVALID_ARG     0x102
+#define ESP_ERR_INVALID_STATE   0x103
+#define ESP_ERR_NOT_FOUND       0x105
+#define ESP_ERR_TIMEOUT         0x107
+#define ESP_ERR_INVALID_CRC     0x109
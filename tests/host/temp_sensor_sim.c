@@ -0,0 +1,26 @@
+#include "temp_sensor_sim.h"
+
+static esp_err_t sim_start(temp_sensor_t *ts) {
+    temp_sim_ctx_t *c = ts->ctx;
+    return c->fail;
+}
+
+static esp_err_t sim_read(temp_sensor_t *ts, int32_t *out_cc, uint32_t timeout_ms) {
+    temp_sim_ctx_t *c = ts->ctx;
+    if (c->fail != ESP_OK) return c->fail;
+    if (!c->values_cc || c->len <= 0) return ESP_ERR_INVALID_STATE;
+    *out_cc = c->values_cc[c->pos];
+    if (++c->pos >= c->len) c->pos = 0;
+    return ESP_OK;
+}
+
+void temp_sensor_sim_init(temp_sensor_t *ts, temp_sim_ctx_t *ctx, const int32_t *values_cc, int len) {
+    ctx->values_cc = values_cc;
+    ctx->len  = len;
+    ctx->pos  = 0;
+    ctx->fail = ESP_OK;
+
+    ts->start = sim_start;
+    ts->read  = sim_read;
+    ts->ctx   = ctx;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "temp_sensor.h"
+
+// Backend simulado do temp_sensor_t p/ o host: devolve a sequência
+// 'values_cc' em loop
+typedef struct {
+    const int32_t *values_cc;
+    int len;
+    int pos;
+    esp_err_t fail; // != ESP_OK força erro de leitura (testa o fallback)
+} temp_sim_ctx_t;
+
+void temp_sensor_sim_init(temp_sensor_t *ts, temp_sim_ctx_t *ctx, const int32_t *values_cc, int len);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+// Asserções mínimas p/ os testes de host: contam falhas e seguem, o main
+// devolve test_end() (0 = tudo ok) p/ o ctest
+
+static int s_test_fails;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+        s_test_fails++; \
+    } \
+} while (0)
+
+#define CHECK_NEAR(a, b, tol) do { \
+    double a_ = (a), b_ = (b); \
+    if (!(fabs(a_ - b_) <= (tol))) { \
+        printf("%s:%d: falhou: %s = %.6f, esperado %.6f +/- %g\n", \
+               __FILE__, __LINE__, #a, a_, b_, (double)(tol)); \
+        s_test_fails++; \
+    } \
+} while (0)
+
+// Relógio monotônico p/ os benchmarks (só informativos, não reprovam)
+static inline double test_now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static inline int test_end(void) {
+    printf("%s\n", s_test_fails ? "FALHOU" : "ok");
+    return s_test_fails != 0;
+}
@@ -0,0 +1,82 @@
+#include "test_common.h"
+#include "energy_model.h"
+#include "lora_airtime.h"
+
+// Perfil de ENERGY_* em emissor_s/main/main.c (com light sleep)
+static const energy_profile_t s_prof = {
+    .sleep_ua       = 20.0f,
+    .active_ma      = 45.0f,
+    .adc_ma         = 2.0f,
+    .tx_ma          = 120.0f,
+    .radio_idle_ma  = 1.6f,
+    .light_sleep_ma = 0.8f,
+    .battery_mah    = 2000.0f,
+};
+
+// Ciclo típico: wake de ~250 ms (boot + ADC + DS18B20 a 10 bits), burst de
+// 3 pacotes de 24 bytes com 200 ms de espera no rádio por pacote
+static energy_cycle_t cycle(uint32_t sleep_s, int sf, uint32_t cycles_per_tx) {
+    lora_phy_t phy = { .sf = sf, .bw_hz = 125000, .cr = 1, .preamble = 8, .crc = true, .ldro = -1 };
+    energy_cycle_t c = {
+        .sleep_s = sleep_s,
+        .awake_us = 250000,
+        .adc_us = 20000,
+        .toa_us = lora_airtime_us(&phy, 24),
+        .tx_packets = 3,
+        .cycles_per_tx = cycles_per_tx,
+    };
+    c.radio_on_us = 30000 + 3 * (c.toa_us + 200000);
+    c.cpu_sleep_us = c.radio_on_us - 30000;
+    return c;
+}
+
+// Conta feita à mão p/ um ciclo só de deep sleep: 20 uA por 3600 s = 20 uAh
+static void test_sleep_only(void) {
+    energy_cycle_t c = { .sleep_s = 3600, .cycles_per_tx = 1 };
+    energy_estimate_t e = energy_estimate(&s_prof, &c);
+    CHECK_NEAR(e.cycle_uah, 20.0, 1e-3);
+    CHECK_NEAR(e.cycle_s, 3600.0, 1e-3);
+    CHECK_NEAR(e.mah_per_day, 0.48, 1e-4);
+    CHECK_NEAR(e.life_days, 2000.0 / 0.48, 0.5);
+    CHECK(e.tx_share == 0.0f);
+}
+
+// Compara configurações: a ordem relativa tem de sair como esperado
+static void test_ordering(void) {
+    energy_estimate_t base = energy_estimate(&s_prof, &(energy_cycle_t){ 0 });
+    CHECK(base.cycle_uah == 0.0f && base.life_days == 0.0f);
+
+    energy_cycle_t c30 = cycle(30, 7, 1), c120 = cycle(120, 7, 1);
+    energy_cycle_t sf12 = cycle(30, 12, 1), batch = cycle(30, 7, 8);
+    energy_estimate_t e30 = energy_estimate(&s_prof, &c30);
+    energy_estimate_t e120 = energy_estimate(&s_prof, &c120);
+    energy_estimate_t e12 = energy_estimate(&s_prof, &sf12);
+    energy_estimate_t eb = energy_estimate(&s_prof, &batch);
+
+    energy_profile_t no_pm = s_prof;
+    no_pm.light_sleep_ma = no_pm.active_ma;
+    energy_estimate_t enp = energy_estimate(&no_pm, &c30);
+
+    printf("SF7  30 s: %6.2f mAh/dia, rádio %2.0f%%, %5.0f dias\n", e30.mah_per_day, e30.tx_share * 100, e30.life_days);
+    printf("SF7 120 s: %6.2f mAh/dia, rádio %2.0f%%, %5.0f dias\n", e120.mah_per_day, e120.tx_share * 100, e120.life_days);
+    printf("SF12 30 s: %6.2f mAh/dia, rádio %2.0f%%, %5.0f dias\n", e12.mah_per_day, e12.tx_share * 100, e12.life_days);
+    printf("lote de 8: %6.2f mAh/dia, rádio %2.0f%%, %5.0f dias\n", eb.mah_per_day, eb.tx_share * 100, eb.life_days);
+    printf("sem PM   : %6.2f mAh/dia, rádio %2.0f%%, %5.0f dias\n", enp.mah_per_day, enp.tx_share * 100, enp.life_days);
+
+    CHECK(e30.tx_share > 0.0f && e30.tx_share < 1.0f);
+    CHECK(e120.mah_per_day < e30.mah_per_day);
+    CHECK(e12.mah_per_day > e30.mah_per_day);
+    CHECK(e12.tx_share > e30.tx_share);
+    CHECK(eb.mah_per_day < e30.mah_per_day);
+    CHECK(eb.tx_share < e30.tx_share);
+    CHECK(enp.mah_per_day > e30.mah_per_day);
+    // a carga por dia bate com carga por ciclo x ciclos por dia
+    CHECK_NEAR(e30.mah_per_day, e30.cycle_uah / 1000.0 * 86400.0 / e30.cycle_s, 1e-3);
+    CHECK_NEAR(e30.life_days * e30.mah_per_day, 2000.0, 0.1);
+}
+
+int main(void) {
+    test_sleep_only();
+    test_ordering();
+    return test_end();
+}
@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "fec.h"
+#include "fec_rx.h"
+#include "payload.h"
+
+// Todos os subconjuntos de k+m shards: reconstrói com >= k presentes e
+// recusa com menos
+static void test_any_k(int k, int m, int len) {
+    static uint8_t buf[FEC_MAX_SHARDS][64], orig[FEC_MAX_K][64];
+    uint8_t *sh[FEC_MAX_SHARDS];
+    int n = k + m, bad = 0;
+    for (int i = 0; i < n; i++) sh[i] = buf[i];
+    for (int j = 0; j < k; j++) {
+        for (int b = 0; b < len; b++) orig[j][b] = (uint8_t)rand();
+    }
+    for (uint32_t mask = 0; mask < (1u << n); mask++) {
+        bool present[FEC_MAX_SHARDS];
+        int have = 0;
+        for (int j = 0; j < k; j++) memcpy(buf[j], orig[j], len);
+        fec_encode((const uint8_t *const *)sh, sh + k, k, m, len);
+        for (int i = 0; i < n; i++) {
+            present[i] = mask >> i & 1;
+            have += present[i];
+            if (!present[i]) memset(buf[i], 0xEE, len);
+        }
+        bool ok = fec_decode(sh, present, k, m, len);
+        if (ok != (have >= k)) bad++;
+        if (ok) {
+            for (int j = 0; j < k; j++) bad += memcmp(buf[j], orig[j], len) != 0;
+        }
+    }
+    CHECK(bad == 0);
+}
+
+// k e m aleatórios até FEC_MAX_SHARDS, ~1/3 dos shards perdidos
+static void test_random(void) {
+    static uint8_t buf[FEC_MAX_SHARDS][64], orig[FEC_MAX_K][64];
+    uint8_t *sh[FEC_MAX_SHARDS];
+    int bad = 0;
+    for (int t = 0; t < 20000; t++) {
+        int k = 1 + rand() % FEC_MAX_K, m = rand() % (FEC_MAX_SHARDS + 1 - k);
+        int len = 1 + rand() % 64, have = 0;
+        bool present[FEC_MAX_SHARDS];
+        for (int i = 0; i < k + m; i++) sh[i] = buf[i];
+        for (int j = 0; j < k; j++) {
+            for (int b = 0; b < len; b++) buf[j][b] = (uint8_t)rand();
+            memcpy(orig[j], buf[j], len);
+        }
+        fec_encode((const uint8_t *const *)sh, sh + k, k, m, len);
+        for (int i = 0; i < k + m; i++) {
+            present[i] = rand() % 3 != 0;
+            have += present[i];
+            if (!present[i]) memset(buf[i], 0xEE, len);
+        }
+        bool ok = fec_decode(sh, present, k, m, len);
+        if (ok != (have >= k)) bad++;
+        if (ok) {
+            for (int j = 0; j < k; j++) bad += memcmp(buf[j], orig[j], len) != 0;
+        }
+    }
+    CHECK(bad == 0);
+}
+
+// Caminho completo do emissor ao receptor: quadro de leituras em shards
+// FEC (FEC_K=2, FEC_M=6 de emissor_s), pacotes embaralhados, perdidos e
+// repetidos, remontagem pelo fec_rx
+#define K  2
+#define M  6
+
+static int make_frame(uint8_t *fb, int cap, uint16_t seq) {
+    payload_reading_t rd[32];
+    for (int i = 0; i < 32; i++) {
+        rd[i] = (payload_reading_t){ (uint16_t)((31 - i) * 60), (uint16_t)(480 + i % 5), 1180,
+                                     (int16_t)(2500 + i), (uint16_t)(34800 + i * 2) };
+    }
+    payload_writer_t w;
+    payload_writer_init(&w, fb, cap, 7, seq, PAYLOAD_F_TEMP);
+    payload_writer_add_packed(&w, rd, 32);
+    return payload_writer_finish(&w);
+}
+
+static int make_packets(const uint8_t *frame, int len, uint16_t seq, uint8_t pk[K + M][64], int *pk_len) {
+    static uint8_t data[K + M][64];
+    uint8_t *sh[K + M];
+    int shard_len = (len + K - 1) / K;
+    memset(data, 0, sizeof(data));
+    memcpy(data, frame, len); // os shards de dados são o quadro em fatias contíguas
+    for (int i = 0; i < K + M; i++) sh[i] = data[0] + i * shard_len;
+    fec_encode((const uint8_t *const *)sh, sh + K, K, M, shard_len);
+    for (int i = 0; i < K + M; i++) {
+        payload_fec_hdr_t h = { .node_id = 7, .seq = seq, .k = K, .m = M, .idx = (uint8_t)i,
+                                .frame_len = (uint16_t)len };
+        pk_len[i] = payload_fec_write(pk[i], 64, &h, sh[i], shard_len);
+        CHECK(pk_len[i] > 0);
+    }
+    return shard_len;
+}
+
+static int push(const uint8_t *pk, int len, uint8_t *out, uint32_t now_ms) {
+    payload_fec_hdr_t h;
+    const uint8_t *shard;
+    int shard_len;
+    CHECK(payload_fec_parse(pk, len, &h, &shard, &shard_len));
+    return fec_rx_push(&h, shard, shard_len, out, 255, now_ms);
+}
+
+static void test_reassembly(void) {
+    uint8_t frame[255], out[255], pk[K + M][64];
+    int pk_len[K + M];
+    uint32_t now = 0;
+
+    for (uint16_t seq = 100; seq < 400; seq++) {
+        int len = make_frame(frame, sizeof(frame), seq);
+        make_packets(frame, len, seq, pk, pk_len);
+
+        // ordem aleatória; chegam só K dos K+M, e um repetido
+        int order[K + M];
+        for (int i = 0; i < K + M; i++) order[i] = i;
+        for (int i = K + M - 1; i > 0; i--) {
+            int j = rand() % (i + 1), t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        CHECK(push(pk[order[0]], pk_len[order[0]], out, now++) == FEC_RX_PENDING);
+        CHECK(push(pk[order[0]], pk_len[order[0]], out, now++) == FEC_RX_PENDING);
+        CHECK(push(pk[order[1]], pk_len[order[1]], out, now++) == len);
+        CHECK(memcmp(out, frame, len) == 0);
+        // shards atrasados do quadro já entregue
+        CHECK(push(pk[order[2]], pk_len[order[2]], out, now++) == FEC_RX_DONE);
+    }
+
+    // dois quadros intercalados ocupam slots diferentes
+    uint8_t pk2[K + M][64], frame2[255];
+    int pk2_len[K + M];
+    int len1 = make_frame(frame, sizeof(frame), 1000);
+    int len2 = make_frame(frame2, sizeof(frame2), 1001);
+    make_packets(frame, len1, 1000, pk, pk_len);
+    make_packets(frame2, len2, 1001, pk2, pk2_len);
+    CHECK(push(pk[3], pk_len[3], out, now++) == FEC_RX_PENDING);
+    CHECK(push(pk2[7], pk2_len[7], out, now++) == FEC_RX_PENDING);
+    CHECK(push(pk2[0], pk2_len[0], out, now++) == len2 && memcmp(out, frame2, len2) == 0);
+    CHECK(push(pk[5], pk_len[5], out, now++) == len1 && memcmp(out, frame, len1) == 0);
+
+    // mesmo (nó, seq) com outra geometria é descartado
+    payload_fec_hdr_t h;
+    const uint8_t *shard;
+    int shard_len;
+    CHECK(payload_fec_parse(pk[0], pk_len[0], &h, &shard, &shard_len));
+    h.m = M - 1;
+    CHECK(fec_rx_push(&h, shard, shard_len, out, 255, now++) == FEC_RX_INVALID);
+    CHECK(!payload_fec_parse(pk[0], PAYLOAD_FEC_HDR_LEN - 1, &h, &shard, &shard_len));
+}
+
+static void bench(void) {
+    static uint8_t buf[K + M][64];
+    uint8_t *sh[K + M];
+    bool present[K + M] = { false, false, true, true, true, true, true, true };
+    for (int i = 0; i < K + M; i++) sh[i] = buf[i];
+    const int n = 20000;
+    double t0 = test_now_ns();
+    for (int i = 0; i < n; i++) {
+        fec_encode((const uint8_t *const *)sh, sh + K, K, M, 51);
+        fec_decode(sh, present, K, M, 51);
+    }
+    printf("bench: %.0f ns por encode + decode sem os %d shards de dados (k=%d m=%d, 51 B)\n",
+           (test_now_ns() - t0) / n, K, K, M);
+}
+
+int main(void) {
+    srand(3);
+    test_any_k(2, 6, 51);
+    test_any_k(4, 4, 17);
+    test_any_k(1, 3, 8);
+    test_random();
+    test_reassembly();
+    bench();
+    return test_end();
+}
@@ -0,0 +1,75 @@
+#include "test_common.h"
+#include "lora_airtime.h"
+
+// Tabela do calculador da Semtech (SX1276): CR 4/5, preâmbulo de 8 símbolos,
+// header explícito, CRC ligado, LDRO automático
+static const struct {
+    int sf;
+    uint32_t bw_hz;
+    int len;
+    uint32_t us;
+} s_table[] = {
+    {  7, 125000, 10,   41216 },
+    {  7, 125000, 51,  102656 },
+    {  7, 250000, 51,   51328 },
+    {  9, 125000, 51,  328704 },
+    { 10, 125000, 20,  370688 },
+    { 11, 125000, 51, 1314816 }, // LDRO ligado (Tsym 16,384 ms)
+    { 12, 125000, 51, 2465792 },
+};
+
+static void test_table(void) {
+    for (int i = 0; i < (int)(sizeof(s_table) / sizeof(s_table[0])); i++) {
+        lora_phy_t phy = { .sf = s_table[i].sf, .bw_hz = s_table[i].bw_hz, .cr = 1,
+                           .preamble = 8, .crc = true, .ldro = -1 };
+        uint32_t us = lora_airtime_us(&phy, s_table[i].len);
+        if (us != s_table[i].us) {
+            printf("SF%d/%lu Hz/%d B: %lu us, esperado %lu\n", s_table[i].sf,
+                   (unsigned long)s_table[i].bw_hz, s_table[i].len,
+                   (unsigned long)us, (unsigned long)s_table[i].us);
+        }
+        CHECK(us == s_table[i].us);
+    }
+}
+
+static void test_options(void) {
+    lora_phy_t phy = { .sf = 7, .bw_hz = 125000, .cr = 1, .preamble = 8, .crc = true, .ldro = -1 };
+    CHECK(lora_symbol_us(&phy) == 1024);
+
+    // header implícito e sem CRC: 36 bits a menos no payload
+    lora_phy_t imp = phy;
+    imp.implicit_header = true;
+    imp.crc = false;
+    CHECK(lora_airtime_us(&imp, 10) < lora_airtime_us(&phy, 10));
+    CHECK(lora_airtime_us(&imp, 10) == 36096); // 8 + 3 * 5 símbolos de payload
+
+    // LDRO forçado em SF7 alonga; desligado em SF12 encurta
+    lora_phy_t ldro = phy;
+    ldro.ldro = 1;
+    CHECK(lora_airtime_us(&ldro, 51) > lora_airtime_us(&phy, 51));
+    lora_phy_t sf12 = { .sf = 12, .bw_hz = 125000, .cr = 1, .preamble = 8, .crc = true, .ldro = 0 };
+    CHECK(lora_airtime_us(&sf12, 51) < 2465792);
+
+    // CR 4/8 e preâmbulo maior só somam símbolos
+    lora_phy_t cr = phy;
+    cr.cr = 4;
+    CHECK(lora_airtime_us(&cr, 10) == 41216 + 4 * 3 * 1024);
+    lora_phy_t pre = phy;
+    pre.preamble = 12;
+    CHECK(lora_airtime_us(&pre, 10) == 41216 + 4 * 1024);
+
+    // fora da faixa
+    CHECK(lora_bw_hz(7) == 125000 && lora_bw_hz(9) == 500000);
+    CHECK(lora_bw_hz(-1) == 0 && lora_bw_hz(10) == 0);
+    phy.sf = 13;
+    CHECK(lora_airtime_us(&phy, 10) == 0);
+    phy.sf = 7;
+    phy.bw_hz = 0;
+    CHECK(lora_airtime_us(&phy, 10) == 0 && lora_symbol_us(&phy) == 0);
+}
+
+int main(void) {
+    test_table();
+    test_options();
+    return test_end();
+}
@@ -0,0 +1,140 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+#include "mac_sched.h"
+
+static void test_helpers(void) {
+    mac_sched_t m;
+    mac_sched_init(&m, 1, 0);
+    CHECK(m.rng != 0);
+
+    // offsets de IDs sequenciais caem espalhados pelos 10 s
+    int bins[10] = { 0 };
+    for (uint32_t id = 1; id <= 1000; id++) {
+        uint32_t off = mac_slot_offset_ms(id, 10000);
+        CHECK(off < 10000);
+        bins[off / 1000]++;
+    }
+    for (int i = 0; i < 10; i++) CHECK(bins[i] > 60 && bins[i] < 140);
+    CHECK(mac_slot_offset_ms(5, 0) == 0);
+
+    int32_t lo = 0, hi = 0;
+    for (int i = 0; i < 100000; i++) {
+        CHECK(mac_rand(&m, 7) < 7);
+        int32_t j = mac_jitter_ms(&m, 1500);
+        if (j < lo) lo = j;
+        if (j > hi) hi = j;
+    }
+    CHECK(lo == -1500 && hi == 1500);
+    CHECK(mac_rand(&m, 0) == 0);
+}
+
+// Simulador de colisões: N emissores ligados juntos (volta da energia), 1 h
+// de quadros em FEC k=2 + m=6 (shards de 63 B, ~226 ms no ar em SF9), timers
+// com +/-0,1 % de erro. Pacote que se sobrepõe a outro se perde; quadro
+// entregue com >= 2 shards. Sem MAC todos usam o mesmo ciclo fixo
+#define SIM_MS        3600000.0
+#define TOA_MS        226.0
+#define SHARDS        8
+#define NEED          2
+#define GAP_MS        500.0
+#define SLEEP_MS      30000.0
+#define MAX_NODES     20
+#define MAX_FRAMES    128
+#define MAX_PKTS      (MAX_NODES * MAX_FRAMES * SHARDS)
+
+typedef struct {
+    double t0, t1;
+    int node, frame;
+} pkt_t;
+
+static pkt_t s_pkt[MAX_PKTS];
+static unsigned char s_ok[MAX_PKTS];
+static int s_good[MAX_NODES][MAX_FRAMES];
+
+static int cmp_pkt(const void *a, const void *b) {
+    double d = ((const pkt_t *)a)->t0 - ((const pkt_t *)b)->t0;
+    return d < 0 ? -1 : d > 0;
+}
+
+// Fração de quadros entregues; *per_h = quadros entregues na hora simulada
+static double simulate(int nodes, bool use_mac, unsigned seed, double *per_h) {
+    srand(seed);
+    int np = 0, frames = 0, delivered = 0;
+    for (int n = 0; n < nodes; n++) {
+        mac_sched_t m;
+        mac_sched_init(&m, (uint32_t)n + 1, (uint32_t)rand());
+        double err = 1.0 + 0.001 * (2.0 * rand() / RAND_MAX - 1.0);
+        double t = rand() % 200;
+        if (use_mac) t += mac_slot_offset_ms((uint32_t)n + 1, 10000) + mac_rand(&m, 1000);
+        for (int f = 0; t < SIM_MS && f < MAX_FRAMES; f++) {
+            for (int i = 0; i < SHARDS; i++) {
+                s_pkt[np++] = (pkt_t){ t, t + TOA_MS, n, f };
+                t += TOA_MS + GAP_MS + (use_mac ? mac_rand(&m, 200) : 0);
+            }
+            double sleep = SLEEP_MS + (use_mac ? mac_jitter_ms(&m, 1500) : 0);
+            t += sleep * err + (use_mac ? mac_rand(&m, 1000) : 0) + 400; // boot + medição
+            frames++;
+        }
+    }
+
+    qsort(s_pkt, np, sizeof(s_pkt[0]), cmp_pkt);
+    double max_end = -1;
+    int max_i = -1;
+    for (int i = 0; i < np; i++) s_ok[i] = 1;
+    for (int i = 0; i < np; i++) {
+        if (s_pkt[i].t0 < max_end) s_ok[i] = s_ok[max_i] = 0;
+        if (s_pkt[i].t1 > max_end) {
+            max_end = s_pkt[i].t1;
+            max_i = i;
+        }
+    }
+    for (int n = 0; n < nodes; n++) {
+        for (int f = 0; f < MAX_FRAMES; f++) s_good[n][f] = 0;
+    }
+    for (int i = 0; i < np; i++) s_good[s_pkt[i].node][s_pkt[i].frame] += s_ok[i];
+    for (int n = 0; n < nodes; n++) {
+        for (int f = 0; f < MAX_FRAMES; f++) delivered += s_good[n][f] >= NEED;
+    }
+    *per_h = delivered * (3600000.0 / SIM_MS);
+    return (double)delivered / frames;
+}
+
+static void test_collisions(void) {
+    static const int nodes[] = { 1, 2, 5, 10, 20 };
+    double prev_mac_h = 0;
+    printf("  N  sem MAC           mac_sched  (fração de quadros entregues, quadros/h)\n");
+    for (int i = 0; i < (int)(sizeof(nodes) / sizeof(nodes[0])); i++) {
+        double lock = 0, mac = 0, lock_h = 0, mac_h = 0, h;
+        for (unsigned r = 1; r <= 5; r++) {
+            lock += simulate(nodes[i], false, r, &h);
+            lock_h += h;
+            mac += simulate(nodes[i], true, r, &h);
+            mac_h += h;
+        }
+        lock /= 5;
+        mac /= 5;
+        lock_h /= 5;
+        mac_h /= 5;
+        printf("%3d   %.3f (%4.0f/h)  %.3f (%4.0f/h)\n", nodes[i], lock, lock_h, mac, mac_h);
+        // um nó sozinho: ~1 quadro a cada 36 s (30 s de sono + burst + boot)
+        if (nodes[i] == 1) CHECK(mac_h > 90 && mac_h < 105);
+        if (nodes[i] > 1) CHECK(mac_h > lock_h);
+        // até 10 nós a vazão total ainda cresce com o nº de nós
+        if (nodes[i] <= 10) CHECK(mac_h > prev_mac_h);
+        prev_mac_h = mac_h;
+        if (nodes[i] == 1) {
+            CHECK(lock == 1.0 && mac == 1.0);
+        } else {
+            CHECK(mac > lock);
+        }
+        if (nodes[i] == 2) CHECK(mac > 0.95);
+    }
+}
+
+int main(void) {
+    test_helpers();
+    test_collisions();
+    return test_end();
+}
@@ -0,0 +1,160 @@
+#include <stdlib.h>
+
+#include "test_common.h"
+#include "node_reg.h"
+
+// Compilado duas vezes: com o NODE_REG_CAP do firmware e com
+// -DNODE_REG_CAP=4096 p/ ver a tabela com milhares de nós
+
+static node_reg_t s_reg;
+
+static uint32_t s_rng = 12345;
+static uint32_t rnd(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// Inserções e remoções aleatórias contra um vetor de referência; IDs de
+// MACs do mesmo OUI (bytes altos iguais)
+#define POOL  (NODE_REG_CAP * 2)
+
+static void test_vs_reference(void) {
+    static uint32_t ids[POOL];
+    static bool in[POOL];
+    uint32_t cnt = 0;
+    int bad = 0;
+    node_reg_reset(&s_reg);
+    for (int i = 0; i < POOL; i++) {
+        ids[i] = 0x24A16000u + (uint32_t)i * 7 + 1;
+        in[i] = false;
+    }
+    for (int it = 0; it < 200000; it++) {
+        int k = (int)(rnd() % POOL);
+        if (rnd() % 3 == 0) {
+            bad += node_reg_remove(&s_reg, ids[k]) != in[k];
+            if (in[k]) cnt--;
+            in[k] = false;
+        } else if (!in[k] && cnt < NODE_REG_MAX_NODES) {
+            node_entry_t *e = node_reg_get(&s_reg, ids[k], (uint32_t)it);
+            e->frames = ids[k];
+            in[k] = true;
+            cnt++;
+        }
+        if (it % 10000 == 0) {
+            for (int j = 0; j < POOL; j++) {
+                node_entry_t *e = node_reg_find(&s_reg, ids[j]);
+                bad += (e != NULL) != in[j] || (e && e->frames != ids[j]);
+            }
+        }
+    }
+    CHECK(bad == 0);
+    CHECK(s_reg.count == cnt);
+    CHECK(s_reg.evicted == 0);
+    CHECK(node_reg_get(&s_reg, 0, 0) == NULL && node_reg_find(&s_reg, 0) == NULL);
+    CHECK(!node_reg_remove(&s_reg, 0));
+}
+
+// Tabela cheia: o nó novo toma o lugar do visto há mais tempo
+static void test_eviction(void) {
+    node_reg_reset(&s_reg);
+    for (uint32_t i = 1; i <= NODE_REG_MAX_NODES; i++) node_reg_get(&s_reg, i, i);
+    CHECK(s_reg.count == NODE_REG_MAX_NODES);
+    node_reg_packet(node_reg_find(&s_reg, 1), 7.3f, -90, 500000);
+    node_entry_t *e = node_reg_get(&s_reg, 999999, 600000);
+    CHECK(e && e->node_id == 999999 && e->first_s == 600000 && e->frames == 0);
+    CHECK(node_reg_find(&s_reg, 1) != NULL);
+    CHECK(node_reg_find(&s_reg, 2) == NULL);
+    CHECK(s_reg.count == NODE_REG_MAX_NODES && s_reg.evicted == 1);
+
+    e = node_reg_find(&s_reg, 1);
+    CHECK(e->packets == 1 && e->rssi == -90 && e->snr_q == 29);
+}
+
+// Dedup por (nó, seq)
+static void test_dedup(void) {
+    node_entry_t e = { 0 };
+    // repetido, fora de ordem dentro da janela, atrás da janela e saltos
+    CHECK(node_reg_frame(&e, 100, 1, 100));
+    CHECK(!node_reg_frame(&e, 100, 1, 100));
+    CHECK(node_reg_frame(&e, 101, 1, 101));
+    CHECK(node_reg_frame(&e, 103, 1, 103));
+    CHECK(e.lost == 1);
+    CHECK(node_reg_frame(&e, 102, 1, 50));   // atrasado: deixa de ser perdido
+    CHECK(e.lost == 0 && e.last_seq == 103 && e.last_ppm == 103 && e.min_ppm == 50);
+    CHECK(!node_reg_frame(&e, 102, 1, 50));
+    CHECK(!node_reg_frame(&e, 101, 1, 101));
+    CHECK(node_reg_frame(&e, 99, 1, 99));    // nunca visto, ainda na janela
+    CHECK(node_reg_frame(&e, 40000, 1, 400)); // salto: emissor reiniciado
+    CHECK(e.resyncs == 1 && e.last_seq == 40000 && e.lost == 0);
+    CHECK(!node_reg_frame(&e, 40000, 1, 400));
+    CHECK(node_reg_frame(&e, 39990, 1, 390));
+    CHECK(e.dups == 4 && e.frames == 7 && e.readings == 7);
+
+    // volta do seq: 65534 -> 1 pula 65535 e 0
+    node_entry_t w = { 0 };
+    node_reg_frame(&w, 65534, 1, 100);
+    node_reg_frame(&w, 1, 1, 120);
+    CHECK(w.lost == 2 && w.last_seq == 1);
+    CHECK(node_reg_frame(&w, 0, 1, 90));
+    CHECK(!node_reg_frame(&w, 1, 1, 90));
+    CHECK(w.lost == 1 && w.frames == 3 && w.min_ppm == 90 && w.max_ppm == 120 && w.last_ppm == 120);
+
+    // burst de 10 cópias por quadro, 200 quadros, reinício no meio
+    node_entry_t b = { 0 };
+    int published = 0;
+    uint16_t seq = 65530;
+    for (int q = 0; q < 200; q++) {
+        if (q == 120) seq = 12345;
+        for (int r = 0; r < 10; r++) published += node_reg_frame(&b, seq, 1, 1);
+        seq++;
+    }
+    CHECK(published == 200 && b.dups == 1800 && b.lost == 0 && b.resyncs == 1);
+}
+
+static uint32_t home(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x & (NODE_REG_CAP - 1);
+}
+
+// Carga máxima: comprimento das sondas e custo da busca
+static void bench(void) {
+    static uint32_t q[NODE_REG_MAX_NODES];
+    const int n = NODE_REG_MAX_NODES, loops = 2000000;
+    node_reg_reset(&s_reg);
+    for (int i = 0; i < n; i++) {
+        q[i] = rnd() | 1;
+        node_reg_get(&s_reg, q[i], 0);
+    }
+    double probes = 0;
+    int max_probe = 0;
+    for (uint32_t i = 0; i < NODE_REG_CAP; i++) {
+        if (!s_reg.e[i].node_id) continue;
+        int d = (int)((i - home(s_reg.e[i].node_id)) & (NODE_REG_CAP - 1)) + 1;
+        probes += d;
+        if (d > max_probe) max_probe = d;
+    }
+    volatile uint32_t sink = 0;
+    double t0 = test_now_ns();
+    for (int i = 0; i < loops; i++) sink += node_reg_find(&s_reg, q[rnd() % n])->packets;
+    double t1 = test_now_ns();
+    for (int i = 0; i < loops; i++) sink += node_reg_find(&s_reg, rnd() | 1) != NULL;
+    double t2 = test_now_ns();
+    printf("cap %d, %d nós, %zu B: sondas méd. %.2f máx. %d; busca %.1f ns, ausente %.1f ns\n",
+           NODE_REG_CAP, n, sizeof(s_reg), probes / n, max_probe, (t1 - t0) / loops, (t2 - t1) / loops);
+    CHECK(s_reg.count == (uint32_t)n);
+    CHECK(probes / n < 5.0); // sondagem linear a 3/4 de carga: ~2,5 esperado
+}
+
+int main(void) {
+    test_vs_reference();
+    test_eviction();
+    test_dedup();
+    bench();
+    return test_end();
+}
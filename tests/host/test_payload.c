@@ -0,0 +1,193 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "payload.h"
+
+// Round-trip do delta_codec: séries suaves (modo BITS) e aleatórias cobrindo
+// int32 inteiro (modo VARINT), n de 1 a 64
+static void test_codec_roundtrip(void) {
+    int32_t v[64];
+    uint8_t b[DELTA_CODEC_MAX_LEN(64)];
+    srand(1);
+    for (int t = 0; t < 2000; t++) {
+        int n = 1 + rand() % 64;
+        for (int i = 0; i < n; i++) {
+            v[i] = (t % 3 == 0) ? (int32_t)((uint32_t)rand() << 1 ^ (uint32_t)rand())
+                                : 35000 + i * 3 + rand() % 7;
+        }
+        int len = delta_codec_encode(v, n, b, sizeof(b));
+        CHECK(len > 0 && len <= DELTA_CODEC_MAX_LEN(n));
+        delta_codec_reader_t r;
+        CHECK(delta_codec_reader_init(&r, b, len, n));
+        int i = 0;
+        int32_t x;
+        while (delta_codec_next(&r, &x)) {
+            if (i >= n || x != v[i]) break;
+            i++;
+        }
+        CHECK(i == n);
+        CHECK(delta_codec_reader_size(&r) == len);
+    }
+
+    // extremos: deltas de 2^32 - 1 fazem round-trip (módulo 2^32)
+    int32_t ext[4] = { INT32_MIN, INT32_MAX, INT32_MIN, 0 };
+    int len = delta_codec_encode(ext, 4, b, sizeof(b));
+    delta_codec_reader_t r;
+    CHECK(delta_codec_reader_init(&r, b, len, 4));
+    for (int i = 0; i < 4; i++) {
+        int32_t x = 1;
+        CHECK(delta_codec_next(&r, &x) && x == ext[i]);
+    }
+
+    // buffer curto e stream truncado
+    CHECK(delta_codec_encode(ext, 4, b, 3) == -1);
+    CHECK(delta_codec_reader_init(&r, b, len - 1, 4));
+    int32_t x;
+    int got = 0;
+    while (delta_codec_next(&r, &x)) got++;
+    CHECK(got < 4);
+}
+
+static void series(payload_reading_t *rd, int n) {
+    for (int i = 0; i < n; i++) {
+        rd[i] = (payload_reading_t){
+            .age_s = (uint16_t)((n - 1 - i) * 60),
+            .tds_ppm = (uint16_t)(480 + i % 5),
+            .mv = (uint16_t)(1180 + (i * 7) % 11),
+            .temp_cc = (int16_t)(2500 + i),
+            .sal_milli = (uint16_t)(34800 + i * 2),
+        };
+    }
+}
+
+static int pack(const payload_reading_t *rd, int n, uint8_t flags, uint8_t *buf, int cap, int *packed) {
+    payload_writer_t w;
+    CHECK(payload_writer_init(&w, buf, cap, 7, 9, flags));
+    *packed = payload_writer_add_packed(&w, rd, n);
+    return payload_writer_finish(&w);
+}
+
+static bool equal(const payload_reading_t *a, const payload_reading_t *b) {
+    return a->age_s == b->age_s && a->tds_ppm == b->tds_ppm && a->mv == b->mv
+        && a->temp_cc == b->temp_cc && a->sal_milli == b->sal_milli;
+}
+
+// Quadro comprimido: round-trip pelo iterador e pelo acesso aleatório, e o
+// tamanho contra o quadro sem compressão (32 leituras com temperatura)
+static void test_frame(void) {
+    payload_reading_t rd[32];
+    uint8_t fb[255];
+    int n;
+    series(rd, 32);
+
+    int len = pack(rd, 32, PAYLOAD_F_TEMP, fb, sizeof(fb), &n);
+    int raw = PAYLOAD_HDR_LEN + 32 * payload_reading_size(PAYLOAD_F_TEMP);
+    printf("32 leituras: %d bytes comprimidas (%.2f B/leitura) contra %d\n",
+           len, (len - PAYLOAD_HDR_LEN) / 32.0, raw);
+    CHECK(n == 32);
+    CHECK(len == 101);
+    CHECK(raw == 329);
+
+    payload_frame_t f;
+    CHECK(payload_parse(fb, len, &f));
+    CHECK(f.hdr.node_id == 7 && f.hdr.seq == 9 && f.hdr.count == 32);
+    CHECK(f.hdr.flags & PAYLOAD_F_DELTA);
+    payload_iter_t it;
+    payload_iter_init(&it, &f);
+    payload_reading_t o;
+    int k = 0;
+    while (payload_iter_next(&it, &o)) {
+        CHECK(k < 32 && equal(&o, &rd[k]));
+        k++;
+    }
+    CHECK(k == 32);
+    CHECK(payload_get_reading(&f, 17, &o) && equal(&o, &rd[17]));
+    CHECK(!payload_get_reading(&f, 32, &o));
+
+    // leitura sem DS18B20 no meio da série
+    rd[5].temp_cc = PAYLOAD_NO_TEMP;
+    rd[5].sal_milli = 0;
+    len = pack(rd, 32, PAYLOAD_F_TEMP, fb, sizeof(fb), &n);
+    printf("com um furo de temperatura: %d bytes\n", len);
+    CHECK(len == 151);
+    CHECK(payload_parse(fb, len, &f));
+    CHECK(payload_get_reading(&f, 5, &o) && o.temp_cc == PAYLOAD_NO_TEMP);
+
+    // quadro truncado não passa no parse
+    CHECK(!payload_parse(fb, len - 1, &f));
+
+    // buffer pequeno: entra o maior prefixo e o quadro continua válido
+    len = pack(rd, 32, PAYLOAD_F_TEMP, fb, 48, &n);
+    CHECK(n > 0 && n < 32 && len <= 48);
+    CHECK(payload_parse(fb, len, &f) && f.hdr.count == n);
+    CHECK(payload_get_reading(&f, n - 1, &o) && equal(&o, &rd[n - 1]));
+}
+
+// Quadro sem compressão com perfil
+static void test_plain_frame(void) {
+    uint8_t b[255];
+    payload_writer_t w;
+    CHECK(payload_writer_init(&w, b, sizeof(b), 0xA1B2C3D4u, 77, PAYLOAD_F_TEMP));
+    payload_profile_t p = { .cycles = 5, .n = 8 };
+    for (int i = 0; i < 8; i++) {
+        p.avg[i] = (uint16_t)(i * 10);
+        p.max[i] = (uint16_t)(i * 20);
+    }
+    CHECK(payload_writer_profile(&w, &p));
+    int n = 0;
+    for (; n < 40; n++) {
+        payload_reading_t r = { (uint16_t)n, (uint16_t)(500 + n), 1200, n % 2 ? 2512 : PAYLOAD_NO_TEMP, 35000 };
+        if (!payload_writer_add(&w, &r)) break;
+    }
+    int len = payload_writer_finish(&w);
+    CHECK(n > 0 && n < 40 && len <= (int)sizeof(b));
+
+    payload_frame_t f;
+    CHECK(payload_parse(b, len, &f));
+    CHECK(f.hdr.node_id == 0xA1B2C3D4u && f.hdr.seq == 77 && f.hdr.count == n);
+    CHECK(f.profile.cycles == 5 && f.profile.n == 8 && f.profile.max[7] == 140);
+    payload_reading_t r;
+    CHECK(payload_get_reading(&f, 3, &r));
+    CHECK(r.age_s == 3 && r.tds_ppm == 503 && r.temp_cc == 2512);
+    CHECK(!payload_parse(b, len - 1, &f));
+}
+
+static void test_ack_beacon(void) {
+    uint8_t b[32];
+    payload_ack_t a = {
+        .node_id = 0x01020304u, .seq = 65535, .has_adr = true, .sf = 9, .tx_dbm = -3,
+        .has_tdma = true, .tdma = { .phase_ms = 12345, .slot_ms = 2000, .nslots = 8 }, .slot = 5,
+    }, o;
+    int len = payload_ack_write(b, sizeof(b), &a);
+    CHECK(len == PAYLOAD_ACK_TDMA_LEN);
+    CHECK(payload_ack_parse(b, len, &o));
+    CHECK(o.node_id == a.node_id && o.seq == a.seq && o.has_adr && o.sf == 9 && o.tx_dbm == -3);
+    CHECK(o.has_tdma && o.tdma.phase_ms == 12345 && o.tdma.slot_ms == 2000 && o.tdma.nslots == 8 && o.slot == 5);
+    CHECK(payload_type(b, len) == PAYLOAD_TYPE_ACK);
+
+    // fase fora do superquadro: bloco TDMA descartado, ADR segue valendo
+    a.tdma.phase_ms = 16000;
+    len = payload_ack_write(b, sizeof(b), &a);
+    CHECK(payload_ack_parse(b, len, &o) && o.has_adr && !o.has_tdma);
+
+    a.has_adr = a.has_tdma = false;
+    len = payload_ack_write(b, sizeof(b), &a);
+    CHECK(len == PAYLOAD_ACK_LEN);
+    CHECK(payload_ack_parse(b, len, &o) && !o.has_adr && !o.has_tdma);
+
+    payload_tdma_t t = { .phase_ms = 7, .slot_ms = 1500, .nslots = 4 }, to;
+    len = payload_beacon_write(b, sizeof(b), &t);
+    CHECK(len == PAYLOAD_BEACON_LEN);
+    CHECK(payload_beacon_parse(b, len, &to));
+    CHECK(to.phase_ms == 7 && to.slot_ms == 1500 && to.nslots == 4);
+    CHECK(!payload_beacon_parse(b, len - 1, &to));
+}
+
+int main(void) {
+    test_codec_roundtrip();
+    test_frame();
+    test_plain_frame();
+    test_ack_beacon();
+    return test_end();
+}
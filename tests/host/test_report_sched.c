@@ -0,0 +1,90 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+#include "report_sched.h"
+
+// Mesmos valores de SOD_* em emissor_s/main/main.c
+static const report_cfg_t s_cfg = {
+    .delta       = 10,
+    .heartbeat_s = 1800,
+    .sleep_min_s = 15,
+    .sleep_max_s = 120,
+    .fast_rate_h = 200,
+};
+
+#define FIXED_SLEEP_S  30   // SLEEP_SECONDS: transmitir em todo wake
+#define DAY_S          86400u
+
+// Série de 24 h: 500 ppm parado, rampa até 800 ppm entre 8 h e 10 h, volta
+// a 500 ppm entre 16 h e 17 h; ruído de +/-2 ppm
+static int32_t series_ppm(uint32_t t_s) {
+    float h = t_s / 3600.0f, v = 500.0f;
+    if (h >= 8 && h < 10) v = 500.0f + 150.0f * (h - 8);
+    else if (h >= 10 && h < 16) v = 800.0f;
+    else if (h >= 16 && h < 17) v = 800.0f - 300.0f * (h - 16);
+    return (int32_t)lroundf(v) + (rand() % 5) - 2;
+}
+
+static void test_first_and_heartbeat(void) {
+    report_state_t st;
+    report_sched_reset(&st);
+    report_decision_t d = report_sched_step(&st, &s_cfg, 500, 0);
+    CHECK(d.reason == REPORT_FIRST);
+    CHECK(d.sleep_s == s_cfg.sleep_min_s);
+
+    d = report_sched_step(&st, &s_cfg, 505, 60);
+    CHECK(d.reason == REPORT_SKIP);
+    CHECK(d.sleep_s > s_cfg.sleep_min_s && d.sleep_s <= s_cfg.sleep_max_s);
+    d = report_sched_step(&st, &s_cfg, 490, 120);
+    CHECK(d.reason == REPORT_DELTA);
+    d = report_sched_step(&st, &s_cfg, 490, 120 + 1799);
+    CHECK(d.reason == REPORT_SKIP);
+    uint32_t sleep_prev = d.sleep_s;
+    d = report_sched_step(&st, &s_cfg, 490, 120 + 1800);
+    CHECK(d.reason == REPORT_HEARTBEAT);
+    CHECK(d.sleep_s > sleep_prev); // tendência decai com o valor parado
+}
+
+// Reproduz a série nos wakes que o agendador pede e compara com o rádio em
+// todo wake de FIXED_SLEEP_S
+static void test_replay(void) {
+    srand(1);
+    report_state_t st;
+    report_sched_reset(&st);
+    uint32_t wakes = 0, reports = 0, last_report_t = 0, max_gap = 0;
+    int32_t max_stale = 0, last = 0;
+    for (uint32_t t = 0; t < DAY_S; ) {
+        int32_t v = series_ppm(t);
+        report_decision_t d = report_sched_step(&st, &s_cfg, v, t);
+        wakes++;
+        if (d.reason != REPORT_SKIP) {
+            reports++;
+            if (t - last_report_t > max_gap) max_gap = t - last_report_t;
+            last_report_t = t;
+            last = v;
+        } else if (abs(v - last) > max_stale) {
+            max_stale = abs(v - last);
+        }
+        t += d.sleep_s;
+    }
+    uint32_t fixed = DAY_S / FIXED_SLEEP_S;
+    printf("24 h: %u wakes, %u reportes contra %u transmissões a cada %u s (%.1f%%)\n",
+           (unsigned)wakes, (unsigned)reports, (unsigned)fixed, FIXED_SLEEP_S,
+           100.0 * reports / fixed);
+    printf("maior intervalo entre reportes %u s, maior desvio não reportado %d ppm\n",
+           (unsigned)max_gap, (int)max_stale);
+
+    // leitura que não foi ao ar nunca se afasta do último valor reportado
+    CHECK(max_stale < s_cfg.delta);
+    // heartbeat respeitado a menos de um sono
+    CHECK(max_gap <= s_cfg.heartbeat_s + s_cfg.sleep_max_s);
+    CHECK(wakes < fixed);
+    CHECK(reports * 5 < fixed);
+}
+
+int main(void) {
+    test_first_and_heartbeat();
+    test_replay();
+    return test_end();
+}
@@ -0,0 +1,103 @@
+#include <math.h>
+
+#include "test_common.h"
+#include "salinity.h"
+
+// PSS-78 direto em double, com as potências de sqrt(Rt) por pow(): referência
+// independente do Horner em float do firmware
+static double pss78_ref(double c_ms_cm, double t90) {
+    static const double a[6] = { 0.0080, -0.1692, 25.3851, 14.0941, -7.0261, 2.7081 };
+    static const double b[6] = { 0.0005, -0.0056, -0.0066, -0.0375, 0.0636, -0.0144 };
+    static const double c[5] = { 0.6766097, 2.00564e-2, 1.104259e-4, -6.9698e-7, 1.0031e-9 };
+    double t = 1.00024 * t90;
+    double rt = 0;
+    for (int i = 0; i < 5; i++) rt += c[i] * pow(t, i);
+    double Rt = c_ms_cm / 42.914 / rt;
+    double ft = (t - 15) / (1 + 0.0162 * (t - 15));
+    double s = 0;
+    for (int i = 0; i < 6; i++) s += (a[i] + ft * b[i]) * pow(Rt, i / 2.0);
+    if (s < 2) {
+        double x = 400 * Rt, y = 100 * Rt;
+        s -= a[0] / (1 + 1.5 * x + x * x) + b[0] * ft / (1 + sqrt(y) + y + y * sqrt(y));
+    }
+    return s;
+}
+
+static void test_reference_points(void) {
+    // definição da escala: R = 1 a 15 °C (IPTS-68) -> S = 35
+    CHECK_NEAR(salinity_pss78(SAL_C35_MS_CM, 15.0f / 1.00024f), 35.0, 1e-3);
+    // 15 °C ITS-90 = 15,0036 °C IPTS-68: já ~3e-3 abaixo de 35
+    CHECK_NEAR(salinity_pss78(SAL_C35_MS_CM, 15.0f), 34.9968, 1e-3);
+    CHECK(salinity_pss78(0.0f, 20.0f) == 0.0f);
+    CHECK(salinity_pss78(-1.0f, 20.0f) == 0.0f);
+    // TEOS-10: S_R = 35,16504 g/kg em S_P = 35
+    CHECK_NEAR(salinity_teos10_sr(35.0f), 35.16504, 1e-4);
+    // TDS 25 °C <-> condutividade: 500 ppm = 1 mS/cm a 25 °C, +2 %/°C
+    CHECK_NEAR(salinity_cond_from_tds(500.0f, 25.0f), 1.0, 1e-6);
+    CHECK_NEAR(salinity_cond_from_tds(500.0f, 35.0f), 1.2, 1e-6);
+}
+
+// Valores publicados, independentes das constantes digitadas aqui e no
+// firmware: o de checagem do UNESCO Tech. Paper 44 (Fofonoff & Millard 1983,
+// R = 1,888091 a 40 °C IPTS-68 e 10000 dbar -> S = 40,0000) e o exemplo do
+// gsw_SP_from_C (TEOS-10 GSW; C em mS/cm, t ITS-90, p em dbar)
+static void test_published(void) {
+    CHECK_NEAR(salinity_pss78_p(1.888091f * SAL_C35_MS_CM, 40.0f / 1.00024f, 10000.0f), 40.0, 1e-4);
+
+    static const struct { float c, t, p; double sp; } gsw[] = {
+        { 34.5487f, 28.7856f,   10.0f, 20.009869599086951 },
+        { 34.7275f, 28.4329f,   50.0f, 20.265511864874270 },
+        { 34.8605f, 22.8103f,  125.0f, 22.981513062527689 },
+        { 34.6810f, 10.2600f,  250.0f, 31.204503263727982 },
+        { 34.5680f,  6.8863f,  600.0f, 34.032315787432829 },
+        { 34.5600f,  4.4036f, 1000.0f, 36.400308494388170 },
+    };
+    for (int i = 0; i < (int)(sizeof(gsw) / sizeof(gsw[0])); i++) {
+        CHECK_NEAR(salinity_pss78_p(gsw[i].c, gsw[i].t, gsw[i].p), gsw[i].sp, 1e-4);
+    }
+    // sem pressão o caminho do firmware é o mesmo
+    CHECK(salinity_pss78(34.5487f, 28.7856f) == salinity_pss78_p(34.5487f, 28.7856f, 0.0f));
+}
+
+// Horner em float contra a referência em double em 1..65 mS/cm e 0..35 °C
+static void test_vs_reference(void) {
+    double max_err = 0;
+    for (double c = 1.0; c <= 65.0; c += 0.25) {
+        for (double t = 0; t <= 35; t += 0.5) {
+            double err = fabs(salinity_pss78((float)c, (float)t) - pss78_ref(c, t));
+            if (err > max_err) max_err = err;
+        }
+    }
+    printf("erro máx. contra a referência em double: %.2e\n", max_err);
+    CHECK(max_err < 1e-4);
+}
+
+// A extensão de Hill emenda sem degrau em S = 2
+static void test_hill_continuity(void) {
+    float prev = salinity_pss78(3.0f, 15.0f);
+    float max_step = 0;
+    for (float c = 3.0f; c <= 4.0f; c += 0.001f) {
+        float s = salinity_pss78(c, 15.0f);
+        CHECK(s >= prev);
+        if (s - prev > max_step) max_step = s - prev;
+        prev = s;
+    }
+    CHECK(max_step < 2e-3f);
+}
+
+static void bench(void) {
+    const int n = 2000000;
+    volatile float sink = 0;
+    double t0 = test_now_ns();
+    for (int i = 0; i < n; i++) sink += salinity_pss78(30.0f + (i & 63) * 0.1f, 18.0f);
+    printf("bench: %.1f ns por salinity_pss78()\n", (test_now_ns() - t0) / n);
+}
+
+int main(void) {
+    test_reference_points();
+    test_published();
+    test_vs_reference();
+    test_hill_continuity();
+    bench();
+    return test_end();
+}
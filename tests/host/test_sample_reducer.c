@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+#include "sample_reducer.h"
+
+static uint32_t s_rng = 0x9E3779B9u;
+
+static uint32_t rnd(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static int cmp_u16(const void *a, const void *b) {
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+// Rede de Batcher contra qsort em todo n, com valores repetidos e extremos
+static void test_sort_vs_qsort(void) {
+    for (int n = 1; n <= REDUCER_MAX_SAMPLES; n++) {
+        for (int rep = 0; rep < 200; rep++) {
+            uint16_t a[REDUCER_MAX_SAMPLES], b[REDUCER_MAX_SAMPLES];
+            uint32_t span = rep % 3 == 0 ? 4 : 4096; // poucos valores distintos
+            for (int i = 0; i < n; i++) a[i] = b[i] = (uint16_t)(rnd() % span);
+            if (rep % 5 == 0) { a[0] = b[0] = 4095; a[n - 1] = b[n - 1] = 0; }
+            reducer_sort(a, n);
+            qsort(b, n, sizeof(b[0]), cmp_u16);
+            if (memcmp(a, b, n * sizeof(a[0])) != 0) {
+                printf("n = %d difere do qsort\n", n);
+                CHECK(0);
+                return;
+            }
+        }
+    }
+}
+
+static void test_modes(void) {
+    uint16_t v5[] = { 9, 1, 5, 3, 7 };
+    CHECK(reducer_apply(REDUCER_MEDIAN, v5, 5) == 5 * 16);
+    uint16_t v4[] = { 4, 1, 2, 3 };
+    CHECK(reducer_apply(REDUCER_MEDIAN, v4, 4) == 40); // 2,5 em Q4
+    uint16_t m[] = { 1, 2 };
+    CHECK(reducer_apply(REDUCER_MEAN, m, 2) == 24);
+    CHECK(reducer_apply(REDUCER_MEAN, m, 0) == 0);
+}
+
+// Burst "gravado": sonda estável em ~1500 contagens com ruído de +/-8 e,
+// em parte dos bursts, glitches do ADC (0 ou 4095) ou uma bolha (queda)
+static void noisy_burst(uint16_t *v, int n, int kind) {
+    for (int i = 0; i < n; i++) v[i] = (uint16_t)(1500 + (int)(rnd() % 17) - 8);
+    if (kind == 1) { v[3] = 4095; v[17] = 0; }
+    if (kind == 2) for (int i = 10; i < 13; i++) v[i] = 300;
+}
+
+static void test_outliers(void) {
+    const int n = 32;
+    int worst_mean = 0, worst[4] = { 0 };
+    for (int rep = 0; rep < 3000; rep++) {
+        uint16_t base[32], v[32];
+        noisy_burst(base, n, rep % 3);
+        for (int mode = REDUCER_MEAN; mode <= REDUCER_SIGMA_CLIP; mode++) {
+            memcpy(v, base, sizeof(v));
+            int err = abs((int)reducer_apply((reducer_mode_t)mode, v, n) - 1500 * 16);
+            if (err > worst[mode]) worst[mode] = err;
+        }
+    }
+    worst_mean = worst[REDUCER_MEAN];
+    printf("erro máx. (contagens): média %.1f, mediana %.1f, aparada %.1f, sigma-clip %.1f\n",
+           worst_mean / 16.0, worst[1] / 16.0, worst[2] / 16.0, worst[3] / 16.0);
+    CHECK(worst_mean > 100 * 16);  // a média simples anda com o glitch
+    CHECK(worst[REDUCER_MEDIAN] <= 8 * 16);
+    CHECK(worst[REDUCER_TRIMMED_MEAN] <= 8 * 16);
+    CHECK(worst[REDUCER_SIGMA_CLIP] <= 8 * 16);
+}
+
+static void bench(void) {
+    const int n = 200000;
+    uint16_t base[32], v[32];
+    noisy_burst(base, 32, 1);
+    volatile uint32_t sink = 0;
+    for (int mode = REDUCER_MEAN; mode <= REDUCER_SIGMA_CLIP; mode++) {
+        double t0 = test_now_ns();
+        for (int i = 0; i < n; i++) {
+            memcpy(v, base, sizeof(v));
+            sink += reducer_apply((reducer_mode_t)mode, v, 32);
+        }
+        printf("bench: modo %d, %.0f ns por burst de 32\n", mode, (test_now_ns() - t0) / n);
+    }
+}
+
+int main(void) {
+    test_sort_vs_qsort();
+    test_modes();
+    test_outliers();
+    bench();
+    return test_end();
+}
@@ -0,0 +1,55 @@
+#include <stdint.h>
+
+#include "test_common.h"
+#include "tds_kernel.h"
+
+#define SAMPLES 32 // burst do emissor
+
+// Kernel Q16 contra o caminho float em toda soma bruta do burst e 0..40 °C
+static void test_vs_float(void) {
+    double max_err = 0;
+    for (int32_t t_cc = 0; t_cc <= 4000; t_cc += 250) {
+        for (uint32_t sum = 0; sum <= SAMPLES * TDS_ADC_MAX; sum++) {
+            float v = (float)sum / SAMPLES * 3.3f / TDS_ADC_MAX;
+            double ref = tds_ppm_float_ref(v, t_cc / 100.0f);
+            double q = tds_ppm_q16_from_raw(sum, SAMPLES, t_cc) / 65536.0;
+            double err = fabs(q - ref);
+            if (err > max_err) max_err = err;
+        }
+    }
+    printf("erro máx. contra o float: %.4f ppm\n", max_err);
+    CHECK(max_err < 0.1);
+}
+
+static void test_edges(void) {
+    CHECK(tds_raw_sum_to_uv(0, SAMPLES) == 0);
+    CHECK(tds_raw_sum_to_uv(SAMPLES * TDS_ADC_MAX, SAMPLES) == TDS_VREF_UV);
+    CHECK(tds_raw_sum_to_uv(123, 0) == 0);
+    CHECK(tds_ppm_q16_from_uv(0, 2500) == 0);
+    // 1 V a 25 °C: 0,5 * (133,42 - 255,86 + 857,39) = 367,475 ppm
+    CHECK_NEAR(tds_ppm_q16_from_uv(1000000, 2500) / 65536.0, 367.475, 0.01);
+    // compensação: 1 V a 35 °C equivale a 1/1,2 V a 25 °C
+    CHECK_NEAR(tds_ppm_q16_from_uv(1000000, 3500) / 65536.0,
+               tds_ppm_float_ref(1.0f / 1.2f, 25.0f), 0.05);
+}
+
+// ns por conversão, kernel inteiro x float (informativo: no host o float é
+// barato; no ESP32 pesam a divisão de 64 bits do kernel e o FPU simples)
+static void bench(void) {
+    const int n = 2000000;
+    volatile int32_t sink_q = 0;
+    volatile float sink_f = 0;
+    double t0 = test_now_ns();
+    for (int i = 0; i < n; i++) sink_q += tds_ppm_q16_from_raw((uint32_t)(i % (SAMPLES * TDS_ADC_MAX)), SAMPLES, 2000);
+    double t1 = test_now_ns();
+    for (int i = 0; i < n; i++) sink_f += tds_ppm_float_ref((float)(i % 4096) * (3.3f / 4095), 20.0f);
+    double t2 = test_now_ns();
+    printf("bench: Q16 %.1f ns, float %.1f ns por conversão\n", (t1 - t0) / n, (t2 - t1) / n);
+}
+
+int main(void) {
+    test_vs_float();
+    test_edges();
+    bench();
+    return test_end();
+}
@@ -0,0 +1,59 @@
+#include <stdint.h>
+
+#include "test_common.h"
+#include "temp_sensor_sim.h"
+#include "tds_kernel.h"
+
+#define TEMPERATURE_C 25.0f // fallback do emissor
+
+// Conversão do scratchpad, com lixo nos bits baixos não usados
+static void test_ds18b20_raw(void) {
+    CHECK(ds18b20_raw_to_cc(0x0191, 12) == 2506);  // 25,0625 °C
+    CHECK(ds18b20_raw_to_cc(0xFF5E, 12) == -1013); // -10,125 °C
+    CHECK(ds18b20_raw_to_cc(0x0550, 12) == 8500);  // 85 °C (valor de power-on)
+    // 25,0625 °C em 9 bits (0,5 °C): os 3 bits baixos são indefinidos
+    CHECK(ds18b20_raw_to_cc(0x0197, 9) == 2500);
+    CHECK(ds18b20_raw_to_cc(0x0193, 10) == 2500);
+    CHECK(ds18b20_raw_to_cc(0x0191, 11) == 2500);
+    CHECK(ds18b20_raw_to_cc(0x0195, 11) == 2525);
+    CHECK(ds18b20_raw_to_cc((int16_t)0xFF5F, 10) == -1025); // -10,25 °C
+}
+
+// Mesmo fluxo do wake: start antes do burst, read depois; com falha usa o
+// fallback. A compensação de 2 %/°C tem que puxar o ppm p/ baixo no quente
+static int32_t wake_ppm(temp_sensor_t *ts, uint32_t uv, int32_t *t_cc) {
+    int32_t t = (int32_t)(TEMPERATURE_C * 100);
+    if (temp_sensor_start(ts) == ESP_OK && temp_sensor_read(ts, t_cc, 1000) == ESP_OK) t = *t_cc;
+    *t_cc = t;
+    return tds_ppm_q16_from_uv(uv, t);
+}
+
+static void test_sim_pipeline(void) {
+    static const int32_t seq[] = { 1500, 2500, 3500 };
+    temp_sensor_t ts;
+    temp_sim_ctx_t ctx;
+    temp_sensor_sim_init(&ts, &ctx, seq, 3);
+
+    int32_t t[4], ppm[4];
+    for (int i = 0; i < 4; i++) ppm[i] = wake_ppm(&ts, 1000000, &t[i]);
+    CHECK(t[0] == 1500 && t[1] == 2500 && t[2] == 3500 && t[3] == 1500); // em loop
+    CHECK(ppm[0] > ppm[1] && ppm[1] > ppm[2]);
+    CHECK_NEAR(ppm[1] / 65536.0, 367.475, 0.01);
+
+    ctx.fail = ESP_ERR_TIMEOUT;
+    int32_t tf;
+    int32_t pf = wake_ppm(&ts, 1000000, &tf);
+    CHECK(tf == 2500);
+    CHECK(pf == ppm[1]);
+
+    temp_sim_ctx_t empty;
+    temp_sensor_sim_init(&ts, &empty, NULL, 0);
+    int32_t x;
+    CHECK(temp_sensor_read(&ts, &x, 0) == ESP_ERR_INVALID_STATE);
+}
+
+int main(void) {
+    test_ds18b20_raw();
+    test_sim_pipeline();
+    return test_end();
+}